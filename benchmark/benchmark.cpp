@@ -0,0 +1,291 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+#include "networkGenerator.h"
+
+struct BenchmarkNetwork {
+    Graph graph;
+    Graph residualGraph;
+    DataRepository dataRepository;
+};
+
+struct BenchmarkConfig {
+    std::vector<unsigned int> scales = {100, 500, 2000};
+    unsigned int seed = 42;
+    unsigned int repeat = 3;
+    unsigned int queries = 10;
+    unsigned int threads = std::max(2u, std::thread::hardware_concurrency());
+    unsigned int corridor = 10000; // stations of the corridor used to benchmark path augmentation, 0 to skip it
+};
+
+/**
+ * Runs a function repeat times and prints the best and average wall-clock time of a run, followed by the average flow
+ * statistics of a run when built with RAILWAY_FLOW_STATS
+ * @param scale - Number of stations of the network, for the report
+ * @param name - Name of the benchmarked operation
+ * @param repeat - Number of timed runs
+ * @param operations - Number of queries done per run, to report the time per query
+ * @param run - Function doing one run
+ */
+void measure(unsigned int scale, const std::string &name, unsigned int repeat, unsigned int operations,
+             const std::function<void()> &run) {
+    double best = 0, total = 0;
+    flowStatistics.reset();
+    for (unsigned int i = 0; i < repeat; i++) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed.count();
+        if (i == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    std::cout << std::setw(8) << scale << std::setw(28) << name << std::setw(8) << operations
+              << std::setw(14) << std::fixed << std::setprecision(3) << best
+              << std::setw(14) << total / repeat
+              << std::setw(14) << best / operations << std::endl;
+
+    if (FlowStatistics::enabled()) {
+        std::cout << std::setw(36) << "";
+        for (const auto &[statistic, value]: flowStatistics.entries())
+            if (value != 0) std::cout << ' ' << statistic << '=' << std::setprecision(3) << value / repeat;
+        std::cout << std::endl;
+    }
+}
+
+void benchmarkScale(unsigned int numStations, const BenchmarkConfig &config) {
+    BenchmarkNetwork network;
+    GeneratorOptions options;
+    options.numStations = numStations;
+    options.numHubs = std::max(4u, numStations / 40);
+    options.extraTrunkLines = options.numHubs / 3;
+    options.seed = config.seed;
+    NetworkGenerator(options, network.graph, network.residualGraph, network.dataRepository).generate();
+
+    Graph &graph = network.graph;
+    Graph &residualGraph = network.residualGraph;
+    std::vector<Vertex *> vertices = graph.getVertexSet();
+
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<size_t> pickVertex(0, vertices.size() - 1);
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::vector<std::string> stations;
+    for (unsigned int i = 0; i < config.queries; i++) {
+        pairs.emplace_back(vertices[pickVertex(rng)]->getId(), vertices[pickVertex(rng)]->getId());
+        stations.push_back(vertices[pickVertex(rng)]->getId());
+    }
+    srand(config.seed);
+    std::vector<Edge *> failedRails = graph.randomlySelectEdges(3);
+
+    measure(numStations, "edmondsKarp", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs) graph.edmondsKarp({source}, target, residualGraph);
+    });
+    measure(numStations, "capacityScaling", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs)
+            graph.maxFlow({source}, target, residualGraph, MaxFlowEngine::CAPACITY_SCALING);
+    });
+    measure(numStations, "edmondsKarp (bidirectional)", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs)
+            graph.maxFlow({source}, target, residualGraph, MaxFlowEngine::EDMONDS_KARP, PathSearch::BIDIRECTIONAL);
+    });
+    measure(numStations, "boykovKolmogorov", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs)
+            graph.maxFlow({source}, target, residualGraph, MaxFlowEngine::BOYKOV_KOLMOGOROV);
+    });
+    std::vector<TerminalFlow> terminalSources, terminalSinks;
+    for (unsigned int i = 0; i < 4; i++) {
+        terminalSources.push_back({(unsigned int) pickVertex(rng), 20, 0});
+        terminalSinks.push_back({(unsigned int) pickVertex(rng), 20, 0});
+    }
+    for (const auto &[engine, name]: {std::make_pair(MaxFlowEngine::EDMONDS_KARP, "edmondsKarp"),
+                                      std::make_pair(MaxFlowEngine::BOYKOV_KOLMOGOROV, "boykovKolmogorov")}) {
+        measure(numStations, std::string("demands (") + name + ")", config.repeat, config.queries, [&] {
+            for (unsigned int i = 0; i < config.queries; i++)
+                graph.multiTerminalMaxFlow(terminalSources, terminalSinks, residualGraph, engine);
+        });
+    }
+    std::vector<Commodity> commodities;
+    for (unsigned int i = 0; i < 10; i++)
+        commodities.push_back({(unsigned int) pickVertex(rng), (unsigned int) pickVertex(rng), 10, 0});
+    measure(numStations, "concurrentFlow (k = 10)", config.repeat, 1, [&] {
+        [[maybe_unused]] ConcurrentFlow flow = graph.maxConcurrentFlow(commodities, residualGraph);
+    });
+    measure(numStations, "failures (edmondsKarp)", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs)
+            graph.maxFlowDeactivatedEdges(failedRails, {source}, target, residualGraph);
+    });
+    measure(numStations, "failures (boykovKolmogorov)", config.repeat, config.queries, [&] {
+        for (const auto &[source, target]: pairs)
+            graph.maxFlowDeactivatedEdges(failedRails, {source}, target, residualGraph,
+                                          MaxFlowEngine::BOYKOV_KOLMOGOROV);
+    });
+    std::vector<Scenario> scenarios;
+    for (unsigned int i = 0; i < config.queries; i++) {
+        Scenario scenario(graph.getTotalEdges());
+        for (Edge const *rail: graph.randomlySelectEdges(3)) scenario.fail(rail->getIndex());
+        scenarios.push_back(scenario);
+    }
+    unsigned int scenarioSource = graph.findVertex(pairs[0].first)->getIndex();
+    unsigned int scenarioTarget = graph.findVertex(pairs[0].second)->getIndex();
+    measure(numStations, "scenarios", config.repeat, config.queries, [&] {
+        [[maybe_unused]] auto flows = graph.scenarioMaxFlows(scenarios, {scenarioSource}, scenarioTarget);
+    });
+    measure(numStations, "scenarios (" + std::to_string(config.threads) + " threads)", config.repeat, config.queries,
+            [&] {
+                [[maybe_unused]] auto flows = graph.scenarioMaxFlows(scenarios, {scenarioSource}, scenarioTarget,
+                                                                     config.threads);
+            });
+    measure(numStations, "incomingFlux", config.repeat, config.queries, [&] {
+        for (const std::string &station: stations) {
+            [[maybe_unused]] Capacity flux = graph.incomingFlux(station, residualGraph);
+        }
+    });
+    measure(numStations, "topGroupings (districts)", 1, 1, [&] {
+        graph.topGroupings(network.dataRepository.getDistrictToStations(), residualGraph);
+    });
+    measure(numStations, "topKGroupings (k = 5)", 1, 1, [&] {
+        std::unordered_map<std::string, Capacity> fluxCache;
+        graph.topKGroupings(network.dataRepository.getDistrictToStations(), residualGraph, fluxCache, 5);
+    });
+    measure(numStations, "topGroupings (" + std::to_string(config.threads) + " threads)", 1, 1, [&] {
+        graph.topGroupings(network.dataRepository.getDistrictToStations(), residualGraph, config.threads);
+    });
+    measure(numStations, "topGroupings (3 levels)", 1, 1, [&] {
+        graph.topGroupings(network.dataRepository.getDistrictToStations(), residualGraph);
+        graph.topGroupings(network.dataRepository.getMunicipalityToStations(), residualGraph);
+        graph.topGroupings(network.dataRepository.getTownshipToStations(), residualGraph);
+    });
+    measure(numStations, "region rollup (3 levels)", 1, 1, [&] {
+        std::unordered_map<std::string, Capacity> fluxCache;
+        RegionRollup rollup = network.dataRepository.getRegionHierarchy().rollUp(
+                graph.stationFluxes(network.dataRepository.getStations(), residualGraph, fluxCache));
+        for (RegionLevel level: {RegionLevel::DISTRICT, RegionLevel::MUNICIPALITY, RegionLevel::TOWNSHIP})
+            [[maybe_unused]] auto ranking = rollup.ranking(level);
+    });
+    if (numStations <= 500) {
+        measure(numStations, "minCostMaxFlow", 1, 2, [&] {
+            for (unsigned int i = 0; i < 2; i++) graph.minCostMaxFlow(pairs[i].first, pairs[i].second, residualGraph);
+        });
+        measure(numStations, "topReductions", 1, 1, [&] {
+            graph.topReductions(failedRails, residualGraph);
+        });
+        measure(numStations, "topKReductions (k = 5)", 1, 1, [&] {
+            graph.topKReductions(failedRails, residualGraph, 5);
+        });
+        measure(numStations, "topReductions (" + std::to_string(config.threads) + " threads)", 1, 1, [&] {
+            graph.topReductions(failedRails, residualGraph, config.threads);
+        });
+        unsigned int source = graph.findVertex(pairs[0].first)->getIndex();
+        unsigned int target = graph.findVertex(pairs[0].second)->getIndex();
+        measure(numStations, "worstFailures (k = 2)", 1, 1, [&] {
+            graph.worstFailures({source}, target, residualGraph, 2);
+        });
+        measure(numStations, "worstFailures (k = 2, " + std::to_string(config.threads) + " thr)", 1, 1, [&] {
+            graph.worstFailures({source}, target, residualGraph, 2, config.threads);
+        });
+    }
+    if (numStations <= 100) {
+        measure(numStations, "calculateNetworkMaxFlow", 1, 1, [&] {
+            graph.calculateNetworkMaxFlow(residualGraph);
+        });
+    }
+}
+
+/**
+ * Builds a single line of numStations stations with random capacities, the shape of a long rail corridor, whose
+ * augmenting paths go through every rail
+ * @param numStations - Number of stations of the corridor
+ * @param seed - Seed of the capacities
+ * @param network - Empty network to build the corridor in
+ */
+void buildCorridor(unsigned int numStations, unsigned int seed, BenchmarkNetwork &network) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned int> pickCapacity(4, 20);
+    network.graph.shareRailActivation(network.residualGraph);
+    for (unsigned int i = 0; i < numStations; i++) {
+        network.graph.addVertex(std::to_string(i));
+        network.residualGraph.addVertex(std::to_string(i));
+    }
+    for (unsigned int i = 0; i + 1 < numStations; i++) {
+        std::string orig = std::to_string(i), dest = std::to_string(i + 1);
+        Capacity capacity = pickCapacity(rng);
+        auto [regular, regularReverse] = network.graph.addAndGetBidirectionalEdge(orig, dest, capacity,
+                                                                                  Service::STANDARD);
+        auto [residual, residualReverse] = network.residualGraph.addAndGetBidirectionalEdge(orig, dest, capacity,
+                                                                                            Service::STANDARD);
+        regular->setCorrespondingEdge(residual);
+        regularReverse->setCorrespondingEdge(residualReverse);
+        residual->setCorrespondingEdge(regular);
+        residualReverse->setCorrespondingEdge(regularReverse);
+    }
+}
+
+/**
+ * Measures following an augmenting path as long as a corridor, alone and together with augmenting it, and max flow
+ * queries along the corridor
+ */
+void benchmarkCorridor(const BenchmarkConfig &config) {
+    const unsigned int numStations = config.corridor;
+    const unsigned int passes = 1000;
+    BenchmarkNetwork network;
+    buildCorridor(numStations, config.seed, network);
+    Graph &graph = network.graph;
+    Graph &residualGraph = network.residualGraph;
+    std::vector<unsigned int> first = {0};
+    unsigned int last = numStations - 1;
+
+    graph.resetFlows();
+    residualGraph.path(first, last);
+    measure(numStations, "path walk (findBottleneck)", config.repeat, passes, [&] {
+        for (unsigned int i = 0; i < passes; i++)
+            [[maybe_unused]] Capacity bottleneck = residualGraph.findBottleneck(last);
+    });
+    // augmenting by 0 writes every flow and capacity of the path back unchanged, so each pass does the same work
+    measure(numStations, "path augment (walk)", config.repeat, passes, [&] {
+        for (unsigned int i = 0; i < passes; i++) residualGraph.augmentPath(last, 0);
+    });
+
+    measure(numStations, "edmondsKarp (corridor)", config.repeat, config.queries, [&] {
+        for (unsigned int i = 0; i < config.queries; i++) graph.edmondsKarp(first, last, residualGraph);
+    });
+}
+
+std::vector<unsigned int> parseScales(const std::string &list) {
+    std::vector<unsigned int> scales;
+    std::istringstream iss(list);
+    std::string scale;
+    while (std::getline(iss, scale, ',')) scales.push_back(std::stoul(scale));
+    return scales;
+}
+
+int main(int argc, char *argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--scales") config.scales = parseScales(argv[i + 1]);
+        else if (option == "--seed") config.seed = std::stoul(argv[i + 1]);
+        else if (option == "--repeat") config.repeat = std::max(1ul, std::stoul(argv[i + 1]));
+        else if (option == "--queries") config.queries = std::max(2ul, std::stoul(argv[i + 1]));
+        else if (option == "--threads") config.threads = std::max(1ul, std::stoul(argv[i + 1]));
+        else if (option == "--corridor") config.corridor = std::stoul(argv[i + 1]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--scales 100,500,2000] [--seed n] [--repeat n] [--queries n]"
+                      << " [--threads n] [--corridor n]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(8) << "STATIONS" << std::setw(28) << "OPERATION" << std::setw(8) << "QUERIES"
+              << std::setw(14) << "BEST (ms)" << std::setw(14) << "AVERAGE (ms)" << std::setw(14) << "PER QUERY"
+              << std::endl;
+    for (unsigned int scale: config.scales) benchmarkScale(scale, config);
+    if (config.corridor >= 2) benchmarkCorridor(config);
+    return 0;
+}
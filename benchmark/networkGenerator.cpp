@@ -0,0 +1,129 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "networkGenerator.h"
+
+NetworkGenerator::NetworkGenerator(const GeneratorOptions &options, Graph &graph, Graph &residualGraph,
+                                   DataRepository &dataRepository)
+        : options(options), rng(options.seed), graph(graph), residualGraph(residualGraph),
+          dataRepository(dataRepository) {
+    graph.shareRailActivation(residualGraph);
+}
+
+unsigned int NetworkGenerator::randomBetween(unsigned int min, unsigned int max) {
+    if (max <= min) return min;
+    return std::uniform_int_distribution<unsigned int>(min, max)(rng);
+}
+
+/**
+ * Adds a new station to the network. Consecutive stations of a line share their municipality and township, and lines
+ * starting at the same hub share their district, so that the administrative groupings are geographically coherent
+ * Time Complexity: O(1) (average case)
+ * @param region - Region (normally, the index of the hub the line starts at) that selects the station's district
+ * @param line - Name of the line of the station
+ * @return Name of the new station
+ */
+std::string NetworkGenerator::addStation(unsigned int region, const std::string &line) {
+    std::string name = "Station " + std::to_string(stationCount);
+    std::string district = "DISTRICT " + std::to_string(region % options.numDistricts);
+    std::string municipality = district + " / MUNICIPALITY " +
+                               std::to_string((stationCount / 7) % options.municipalitiesPerDistrict);
+    std::string township = municipality + " / Township " +
+                           std::to_string((stationCount / 3) % options.townshipsPerMunicipality);
+    stationCount++;
+
+    graph.addVertex(name);
+    residualGraph.addVertex(name);
+    dataRepository.addStationEntry(name, district, municipality, township, line);
+    return name;
+}
+
+/**
+ * Adds a rail to the network and to its residual network, with a capacity drawn from the trunk or branch distribution
+ * Time Complexity: O(1) (average case)
+ */
+void NetworkGenerator::addRail(const std::string &source, const std::string &dest, bool trunk) {
+    unsigned int capacity = trunk ? randomBetween(options.trunkMinCapacity, options.trunkMaxCapacity)
+                                  : randomBetween(options.branchMinCapacity, options.branchMaxCapacity);
+    Service service = trunk && std::bernoulli_distribution(options.alfaPendularShare)(rng) ? Service::ALFA_PENDULAR
+                                                                                          : Service::STANDARD;
+
+    auto [regular, regularReverse] = graph.addAndGetBidirectionalEdge(source, dest, capacity, service);
+    auto [residual, residualReverse] = residualGraph.addAndGetBidirectionalEdge(source, dest, capacity, service);
+    regular->setCorrespondingEdge(residual);
+    regularReverse->setCorrespondingEdge(residualReverse);
+    residual->setCorrespondingEdge(regular);
+    residualReverse->setCorrespondingEdge(regularReverse);
+}
+
+/**
+ * Adds a high capacity line connecting two hubs through length new intermediate stations
+ * Time Complexity: O(length)
+ */
+void NetworkGenerator::addTrunkLine(const std::string &fromHub, const std::string &toHub, unsigned int length) {
+    std::string line = "Trunk Line " + std::to_string(lineCount++);
+    unsigned int region = std::stoul(fromHub.substr(fromHub.find(' ') + 1));
+    std::string previous = fromHub;
+    for (unsigned int i = 0; i < length; i++) {
+        std::string station = addStation(region, line);
+        addRail(previous, station, true);
+        trunkStations.push_back(station);
+        previous = station;
+    }
+    addRail(previous, toHub, true);
+}
+
+/**
+ * Adds a low capacity dead-end line of length new stations, leaving the network at a junction station
+ * Time Complexity: O(length)
+ */
+void NetworkGenerator::addBranchLine(const std::string &junction, unsigned int length) {
+    std::string line = "Branch Line " + std::to_string(lineCount++);
+    unsigned int region = randomBetween(0, options.numHubs - 1);
+    std::string previous = junction;
+    for (unsigned int i = 0; i < length; i++) {
+        std::string station = addStation(region, line);
+        addRail(previous, station, false);
+        previous = station;
+    }
+}
+
+/**
+ * Generates a rail-like network: hubs connected by a spanning tree of trunk lines plus a few extra trunk lines closing
+ * loops, with the remaining stations on dead-end branch lines leaving from trunk stations
+ * Time Complexity: O(n), n being the number of stations
+ */
+void NetworkGenerator::generate() {
+    unsigned int numHubs = std::max(2u, std::min(options.numHubs, options.numStations / 4));
+    options.numHubs = numHubs;
+
+    std::vector<std::string> hubs;
+    for (unsigned int i = 0; i < numHubs; i++) {
+        hubs.push_back(addStation(i, "Hub"));
+        trunkStations.push_back(hubs.back());
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> trunkLines;
+    for (unsigned int i = 1; i < numHubs; i++) trunkLines.emplace_back(randomBetween(0, i - 1), i);
+    for (unsigned int i = 0; i < options.extraTrunkLines; i++) {
+        unsigned int from = randomBetween(0, numHubs - 1), to = randomBetween(0, numHubs - 1);
+        if (from != to) trunkLines.emplace_back(from, to);
+    }
+
+    auto trunkBudget = (unsigned int) (options.numStations * options.trunkShare);
+    trunkBudget = trunkBudget > numHubs ? trunkBudget - numHubs : 0;
+    unsigned int averageLength = std::max(1u, trunkBudget / (unsigned int) trunkLines.size());
+    for (const auto &[from, to]: trunkLines) {
+        unsigned int remaining = options.numStations - stationCount;
+        unsigned int length = std::min(remaining, randomBetween(averageLength / 2, averageLength * 3 / 2));
+        addTrunkLine(hubs[from], hubs[to], length);
+    }
+
+    while (stationCount < options.numStations) {
+        const std::string &junction = trunkStations[randomBetween(0, (unsigned int) trunkStations.size() - 1)];
+        unsigned int length = std::min(options.numStations - stationCount,
+                                       randomBetween(1, options.maxBranchLength));
+        addBranchLine(junction, length);
+    }
+}
@@ -0,0 +1,60 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_NETWORKGENERATOR_H
+#define RAILWAYMANAGEMENT_NETWORKGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include "graph.h"
+#include "dataRepository.h"
+
+struct GeneratorOptions {
+    unsigned int numStations = 500;
+    unsigned int numHubs = 12;               // junction stations where trunk lines meet
+    unsigned int extraTrunkLines = 4;        // trunk lines beyond the spanning ones, closing loops between hubs
+    double trunkShare = 0.6;                 // fraction of the stations placed on trunk lines (the rest on branches)
+    unsigned int maxBranchLength = 12;
+    unsigned int trunkMinCapacity = 8;
+    unsigned int trunkMaxCapacity = 24;
+    unsigned int branchMinCapacity = 2;
+    unsigned int branchMaxCapacity = 8;
+    double alfaPendularShare = 0.3;          // fraction of the trunk rails served by Alfa Pendular
+    unsigned int numDistricts = 18;
+    unsigned int municipalitiesPerDistrict = 6;
+    unsigned int townshipsPerMunicipality = 4;
+    unsigned int seed = 42;
+};
+
+class NetworkGenerator {
+  private:
+    GeneratorOptions options;
+    std::mt19937 rng;
+    Graph &graph;
+    Graph &residualGraph;
+    DataRepository &dataRepository;
+    std::vector<std::string> trunkStations;
+    unsigned int stationCount = 0;
+    unsigned int lineCount = 0;
+
+    unsigned int randomBetween(unsigned int min, unsigned int max);
+
+    std::string addStation(unsigned int region, const std::string &line);
+
+    void addRail(const std::string &source, const std::string &dest, bool trunk);
+
+    void addTrunkLine(const std::string &fromHub, const std::string &toHub, unsigned int length);
+
+    void addBranchLine(const std::string &junction, unsigned int length);
+
+  public:
+    NetworkGenerator(const GeneratorOptions &options, Graph &graph, Graph &residualGraph,
+                     DataRepository &dataRepository);
+
+    void generate();
+};
+
+
+#endif //RAILWAYMANAGEMENT_NETWORKGENERATOR_H
@@ -3,170 +3,209 @@
 //
 
 #include <iostream>
+#include <stdexcept>
 #include "dataRepository.h"
 
 using namespace std;
 
 DataRepository::DataRepository() = default;
 
-const stationTable &DataRepository::getStations() const {
+const vector<Station> &DataRepository::getStations() const {
     return stations;
 }
 
-void DataRepository::setStations(const stationTable &stations) {
-    this->stations = stations;
+const Dictionary &DataRepository::getDistricts() const {
+    return districts;
 }
 
-const unordered_map<std::string, std::list<Station>> &DataRepository::getDistrictToStations() const {
-    return districtToStations;
+const Dictionary &DataRepository::getMunicipalities() const {
+    return municipalities;
 }
 
-void DataRepository::setDistrictToStations(const unordered_map<std::string, std::list<Station>> &districtToStations) {
-    DataRepository::districtToStations = districtToStations;
+const Dictionary &DataRepository::getTownships() const {
+    return townships;
 }
 
-const unordered_map<std::string, std::list<Station>> &DataRepository::getMunicipalityToStations() const {
-    return municipalityToStations;
+const Dictionary &DataRepository::getLines() const {
+    return lines;
+}
+
+const ServiceCostModel &DataRepository::getServiceCosts() const {
+    return serviceCosts;
+}
+
+ServiceCostModel &DataRepository::getServiceCosts() {
+    return serviceCosts;
+}
+
+/**
+ * Rebuilds the district, municipality and township groupings, the region hierarchy and the name index if stations were
+ * added since they were last built. Can be called by several threads at the same time
+ * Time Complexity: O(n + g) (if rebuilt) | O(1) (otherwise), n being the number of stations and g that of groups
+ */
+void DataRepository::updateGroupings() const {
+    lock_guard<mutex> lock(groupingsMutex);
+    if (groupingsValid) return;
+    districtToStations.build(districts, stations, &Station::getDistrict);
+    municipalityToStations.build(municipalities, stations, &Station::getMunicipality);
+    townshipToStations.build(townships, stations, &Station::getTownship);
+    regionHierarchy.build(stations, districts, municipalities, townships);
+    nameIndex.build(stations);
+    groupingsValid = true;
+}
+
+const StationGrouping &DataRepository::getDistrictToStations() const {
+    updateGroupings();
+    return districtToStations;
 }
 
-void DataRepository::setMunicipalityToStations(
-        const unordered_map<std::string, std::list<Station>> &municipalityToStations) {
-    DataRepository::municipalityToStations = municipalityToStations;
+const StationGrouping &DataRepository::getMunicipalityToStations() const {
+    updateGroupings();
+    return municipalityToStations;
 }
 
-const unordered_map<std::string, std::list<Station>> &DataRepository::getTownshipToStations() const {
+const StationGrouping &DataRepository::getTownshipToStations() const {
+    updateGroupings();
     return townshipToStations;
 }
 
-void DataRepository::setTownshipToStations(const unordered_map<std::string, std::list<Station>> &townshipToStations) {
-    DataRepository::townshipToStations = townshipToStations;
+const RegionHierarchy &DataRepository::getRegionHierarchy() const {
+    updateGroupings();
+    return regionHierarchy;
 }
 
 /**
- * Adds a new entry to the unordered_set of Stations, creating the corresponding Station object
+ * Adds a new Station to the station table, with the next free id, interning its district, municipality, township and
+ * line. The station is added to the district, municipality and township groupings
  * Time Complexity: O(1) (average case) | O(size(stations)) (worst case)
  * @param name - Name of the station to be created
  * @param district - District of the Station to be created
  * @param municipality - Municipality of the Station to be created
  * @param township - Township of the Station to be created
  * @param line - Line of the station to be created
- * @return New Station object created
+ * @return New Station object created, or the existing one if there already is a Station with that name
  */
 Station
 DataRepository::addStationEntry(const std::string &name, const std::string &district, const std::string &municipality,
                                 const std::string &township,
                                 const std::string &line) {
-    Station newStation = Station(name, district, municipality, township, line);
-    stations.insert(newStation);
-    return newStation;
-}
-
+    auto [it, inserted] = nameToStation.emplace(name, (unsigned int) stations.size());
+    if (!inserted) return stations[it->second];
 
-/**
- * Adds a new Station value to an entry in the districtToStations unordered_map
- * Time Complexity: O(1) (average case) | O(size(districtToStations)) (worst case)
- * @param district - District of the new Station
- * @param station - Station to add
- */
-void DataRepository::addStationToDistrictEntry(const string &district, const Station &station) {
-    districtToStations[district].push_back(station);
+    stations.emplace_back(name, it->second, districts.intern(district), municipalities.intern(municipality),
+                          townships.intern(township), lines.intern(line));
+    lock_guard<mutex> lock(groupingsMutex);
+    groupingsValid = false;
+    return stations.back();
 }
 
+
 /**
- * Adds a new Station value to an entry in the municipalityToStations unordered_map
- * Time Complexity: O(1) (average case) | O(size(municipalityToStations)) (worst case)
- * @param municipality - Municipality of the new Station
- * @param station - Station to add
+ * Finds the Station object with the given name
+ * Time Complexity: O(1) (average case) | O(size(stations)) (worst case)
+ * @param name - Name of the Station to be returned
+ * @return optional<Station> value which will contain the Station object, or be empty if no such Station was found
  */
-void DataRepository::addStationToMunicipalityEntry(const std::string &municipality, const Station &station) {
-    municipalityToStations[municipality].push_back(station);
+std::optional<Station> DataRepository::findStation(const string &name) const {
+    std::optional<Station> result;
+    auto it = nameToStation.find(name);
+    if (it != nameToStation.end()) result = stations[it->second];
+    return result;
 }
 
 /**
- * Adds a new Station value to an entry in the townshipToStations unordered_map
- * Time Complexity: O(1) (average case) | O(size(townshipToStations)) (worst case)
- * @param township - Township of the new Station
- * @param station - Station to add
+ * Finds the Stations whose name starts with a prefix, ignoring case and accents
+ * Time Complexity: O(log(n) + limit), n being the number of stations
+ * @param prefix - Beginning of the name
+ * @param limit - Maximum number of Stations returned
+ * @return vector<Station> with the Stations found, in alphabetical order
  */
-void DataRepository::addStationToTownshipEntry(const std::string &township, const Station &station) {
-    townshipToStations[township].push_back(station);
+std::vector<Station> DataRepository::findStationsByPrefix(const string &prefix, unsigned int limit) const {
+    updateGroupings();
+    std::vector<Station> result;
+    for (unsigned int id: nameIndex.findPrefix(prefix, limit)) result.push_back(stations[id]);
+    return result;
 }
 
-
 /**
- * Finds the Station object with the given name
- * Time Complexity: O(1) (average case) | O(size(stations)) (worst case)
- * @param name - Name of the Station to be returned
- * @return optional<Station> value which will contain the Station object, or be empty if no such Station was found
+ * Finds the Stations whose name is within an edit distance of the given one, ignoring case and accents, so that
+ * misspelled names can be corrected
+ * Time Complexity: See StationNameIndex::findSimilar
+ * @param name - (Possibly misspelled) name of the Station
+ * @param maxDistance - Maximum number of inserted, deleted or replaced characters
+ * @param limit - Maximum number of Stations returned
+ * @return vector<Station> with the Stations found, closest first
  */
-std::optional<Station> DataRepository::findStation(const string &name) {
-    std::optional<Station> result;
-    auto it = stations.find(Station(name));
-    if (it != stations.end()) result = *it;
+std::vector<Station>
+DataRepository::findSimilarStations(const string &name, unsigned int maxDistance, unsigned int limit) const {
+    updateGroupings();
+    std::vector<Station> result;
+    for (const auto &[id, distance]: nameIndex.findSimilar(name, maxDistance, limit)) result.push_back(stations[id]);
     return result;
 }
 
-
 /**
  * Finds the Station objects with the given district
- * Time Complexity: O(1) (average case) | O(size(districtToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(districts)) (worst case)
  * @param district - District whose Stations should be found
- * @return list<Station> containing the Stations in the given district
+ * @return StationSpan with the ids of the Stations in the given district; throws std::out_of_range if unknown
  */
-list<Station> DataRepository::findStationsInDistrict(const std::string &district) {
-    return districtToStations.at(district);
+StationSpan DataRepository::findStationsInDistrict(const std::string &district) const {
+    optional<unsigned int> group = districts.find(district);
+    if (!group.has_value()) throw out_of_range("Unknown district " + district);
+    return getDistrictToStations().getStations(group.value());
 }
 
 /**
  * Finds the Station objects with the given municipality
- * Time Complexity: O(1) (average case) | O(size(municipalityToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(municipalities)) (worst case)
  * @param municipality - Municipality whose Stations should be found
- * @return list<Station> containing the Stations in the given municipality
+ * @return StationSpan with the ids of the Stations in the given municipality; throws std::out_of_range if unknown
  */
-list<Station> DataRepository::findStationsInMunicipality(const std::string &municipality) {
-    return municipalityToStations.at(municipality);
+StationSpan DataRepository::findStationsInMunicipality(const std::string &municipality) const {
+    optional<unsigned int> group = municipalities.find(municipality);
+    if (!group.has_value()) throw out_of_range("Unknown municipality " + municipality);
+    return getMunicipalityToStations().getStations(group.value());
 }
 
 /**
  * Finds the Station objects with the given township
- * Time Complexity: O(1) (average case) | O(size(townshipToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(townships)) (worst case)
  * @param township - Township whose Stations should be found
- * @return list<Station> containing the Stations in the given township
+ * @return StationSpan with the ids of the Stations in the given township; throws std::out_of_range if unknown
  */
-list<Station> DataRepository::findStationsInTownship(const std::string &township) {
-    return townshipToStations.at(township);
+StationSpan DataRepository::findStationsInTownship(const std::string &township) const {
+    optional<unsigned int> group = townships.find(township);
+    if (!group.has_value()) throw out_of_range("Unknown township " + township);
+    return getTownshipToStations().getStations(group.value());
 }
 
 /**
  * Checks if the given district is valid, that is, if there is stored data referencing it
- * Time Complexity: O(1) (average case) | O(size(districtToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(districts)) (worst case)
  * @param district - District to be validated
  * @return true if the district is valid, false if it is not
  */
-bool DataRepository::checkValidDistrict(const std::string &district) {
-    return districtToStations.find(district) != districtToStations.end();
+bool DataRepository::checkValidDistrict(const std::string &district) const {
+    return districts.find(district).has_value();
 }
 
 /**
  * Checks if the given municipality is valid, that is, if there is stored data referencing it
- * Time Complexity: O(1) (average case) | O(size(municipalityToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(municipalities)) (worst case)
  * @param municipality - Municipality to be validated
  * @return true if the municipality is valid, false if it is not
  */
-bool DataRepository::checkValidMunicipality(const std::string &municipality) {
-    return municipalityToStations.find(municipality) != municipalityToStations.end();
+bool DataRepository::checkValidMunicipality(const std::string &municipality) const {
+    return municipalities.find(municipality).has_value();
 }
 
 /**
  * Checks if the given township is valid, that is, if there is stored data referencing it
- * Time Complexity: O(1) (average case) | O(size(townshipToStations)) (worst case)
+ * Time Complexity: O(1) (average case) | O(size(townships)) (worst case)
  * @param township - Township to be validated
  * @return true if the township is valid, false if it is not
  */
-bool DataRepository::checkValidTownship(const std::string &township) {
-    return townshipToStations.find(township) != townshipToStations.end();
+bool DataRepository::checkValidTownship(const std::string &township) const {
+    return townships.find(township).has_value();
 }
-
-
-
-
@@ -5,63 +5,93 @@
 #ifndef RAILWAYMANAGEMENT_DATAREPOSITORY_H
 #define RAILWAYMANAGEMENT_DATAREPOSITORY_H
 
-#include <list>
+#include <vector>
 #include <optional>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include "station.h"
+#include "dictionary.h"
+#include "stationGrouping.h"
+#include "regionHierarchy.h"
+#include "stationNameIndex.h"
+#include "serviceCostModel.h"
 
 
 class DataRepository {
 
 
 private:
-    stationTable stations;
-    std::unordered_map<std::string, std::list<Station>> districtToStations;
-    std::unordered_map<std::string, std::list<Station>> municipalityToStations;
-    std::unordered_map<std::string, std::list<Station>> townshipToStations;
+    std::vector<Station> stations; // indexed by id
+    std::unordered_map<std::string, unsigned int> nameToStation;
+    Dictionary districts;
+    Dictionary municipalities;
+    Dictionary townships;
+    Dictionary lines;
+    ServiceCostModel serviceCosts;
+
+    // groupings of the stations, rebuilt on demand after stations are added
+    mutable std::mutex groupingsMutex;
+    mutable bool groupingsValid = false;
+    mutable StationGrouping districtToStations;
+    mutable StationGrouping municipalityToStations;
+    mutable StationGrouping townshipToStations;
+    mutable RegionHierarchy regionHierarchy;
+    mutable StationNameIndex nameIndex;
+
+    void updateGroupings() const;
 
 public:
     DataRepository();
 
-    const stationTable &getStations() const;
+    DataRepository(const DataRepository &) = delete;
 
-    void setStations(const stationTable &Stations);
+    DataRepository &operator=(const DataRepository &) = delete;
 
-    const std::unordered_map<std::string, std::list<Station>> &getDistrictToStations() const;
+    const std::vector<Station> &getStations() const;
 
-    void setDistrictToStations(const std::unordered_map<std::string, std::list<Station>> &districtToStations);
+    const Dictionary &getDistricts() const;
 
-    const std::unordered_map<std::string, std::list<Station>> &getTownshipToStations() const;
+    const Dictionary &getMunicipalities() const;
 
-    void setTownshipToStations(const std::unordered_map<std::string, std::list<Station>> &townshipToStations);
+    const Dictionary &getTownships() const;
 
-    const std::unordered_map<std::string, std::list<Station>> &getMunicipalityToStations() const;
+    const Dictionary &getLines() const;
 
-    void setMunicipalityToStations(const std::unordered_map<std::string, std::list<Station>> &municipalityToStations);
+    const ServiceCostModel &getServiceCosts() const;
 
-    std::optional<Station> findStation(const std::string &name);
+    ServiceCostModel &getServiceCosts();
 
-    Station addStationEntry(const std::string &name, const std::string &district, const std::string &municipality,
-                             const std::string &township,
-                             const std::string &line);
+    const StationGrouping &getDistrictToStations() const;
+
+    const StationGrouping &getTownshipToStations() const;
+
+    const StationGrouping &getMunicipalityToStations() const;
 
-    void addStationToDistrictEntry(const std::string &district, const Station &station);
+    const RegionHierarchy &getRegionHierarchy() const;
 
-    void addStationToMunicipalityEntry(const std::string &municipality, const Station &station);
+    std::optional<Station> findStation(const std::string &name) const;
 
-    std::list<Station> findStationsInDistrict(const std::string &district);
+    std::vector<Station> findStationsByPrefix(const std::string &prefix, unsigned int limit) const;
+
+    std::vector<Station> findSimilarStations(const std::string &name, unsigned int maxDistance,
+                                             unsigned int limit) const;
+
+    Station addStationEntry(const std::string &name, const std::string &district, const std::string &municipality,
+                             const std::string &township,
+                             const std::string &line);
 
-    bool checkValidDistrict(const std::string &district);
+    StationSpan findStationsInDistrict(const std::string &district) const;
 
-    bool checkValidMunicipality(const std::string &municipality);
+    bool checkValidDistrict(const std::string &district) const;
 
-    std::list<Station> findStationsInMunicipality(const std::string &municipality);
+    bool checkValidMunicipality(const std::string &municipality) const;
 
-    std::list<Station> findStationsInTownship(const std::string &township);
+    StationSpan findStationsInMunicipality(const std::string &municipality) const;
 
-    void addStationToTownshipEntry(const std::string &township, const Station &station);
+    StationSpan findStationsInTownship(const std::string &township) const;
 
-    bool checkValidTownship(const std::string &township);
+    bool checkValidTownship(const std::string &township) const;
 };
 
 
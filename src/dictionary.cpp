@@ -0,0 +1,39 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "dictionary.h"
+
+Dictionary::Dictionary() = default;
+
+/**
+ * Finds the id of a name, giving it the next free id if it wasn't in the dictionary yet
+ * Time Complexity: O(1) (average case) | O(size(names)) (worst case)
+ * @param name - Name to intern
+ * @return Id of the name
+ */
+unsigned int Dictionary::intern(const std::string &name) {
+    auto [it, inserted] = nameToId.emplace(name, (unsigned int) names.size());
+    if (inserted) names.push_back(name);
+    return it->second;
+}
+
+/**
+ * Finds the id of a name, without adding it
+ * Time Complexity: O(1) (average case) | O(size(names)) (worst case)
+ * @param name - Name to look for
+ * @return optional<unsigned int> with the id of the name, or empty if it isn't in the dictionary
+ */
+std::optional<unsigned int> Dictionary::find(const std::string &name) const {
+    auto it = nameToId.find(name);
+    if (it == nameToId.end()) return std::nullopt;
+    return it->second;
+}
+
+const std::string &Dictionary::getName(unsigned int id) const {
+    return names[id];
+}
+
+unsigned int Dictionary::size() const {
+    return (unsigned int) names.size();
+}
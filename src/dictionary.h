@@ -0,0 +1,31 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_DICTIONARY_H
+#define RAILWAYMANAGEMENT_DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+class Dictionary {
+  private:
+    std::vector<std::string> names; // indexed by id
+    std::unordered_map<std::string, unsigned int> nameToId;
+
+  public:
+    Dictionary();
+
+    unsigned int intern(const std::string &name);
+
+    [[nodiscard]] std::optional<unsigned int> find(const std::string &name) const;
+
+    [[nodiscard]] const std::string &getName(unsigned int id) const;
+
+    [[nodiscard]] unsigned int size() const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_DICTIONARY_H
@@ -4,7 +4,7 @@
 
 #include "edge.h"
 
-Edge::Edge(Vertex *orig, Vertex *dest, unsigned int capacity, Service service) {
+Edge::Edge(Vertex *orig, Vertex *dest, Capacity capacity, Service service) {
     this->orig = orig;
     this->dest = dest;
     this->capacity = capacity;
@@ -16,7 +16,7 @@ Vertex *Edge::getDest() const {
     return this->dest;
 }
 
-unsigned int Edge::getCapacity() const {
+Capacity Edge::getCapacity() const {
     return this->capacity;
 }
 
@@ -32,11 +32,7 @@ Service Edge::getService() const {
     return service;
 }
 
-bool Edge::isSelected() const {
-    return this->selected;
-}
-
-unsigned int Edge::getFlow() const {
+Capacity Edge::getFlow() const {
     return flow;
 }
 
@@ -45,10 +41,6 @@ void Edge::initializeCost() {
     if (service == Service::VERY_EXPENSIVE) cost = 6;
 }
 
-void Edge::setSelected(bool s) {
-    this->selected = s;
-}
-
 void Edge::setReverse(Edge *r) {
     this->reverse = r;
 }
@@ -57,7 +49,7 @@ void Edge::setService(Service s) {
     Edge::service = s;
 }
 
-void Edge::setFlow(unsigned int f) {
+void Edge::setFlow(Capacity f) {
     this->flow = f;
 }
 
@@ -65,7 +57,7 @@ void Edge::print() const {
     std::cout << orig->getId() << " <-> " << dest->getId() << std::endl;
 }
 
-void Edge::setCapacity(unsigned int c) {
+void Edge::setCapacity(Capacity c) {
     this->capacity = c;
 }
 
@@ -77,12 +69,26 @@ void Edge::setCorrespondingEdge(Edge *correspondingEdge) {
     Edge::correspondingEdge = correspondingEdge;
 }
 
-void Edge::setCost(int cost) {
+void Edge::setCost(Cost cost) {
     Edge::cost = cost;
 }
 
-int Edge::getCost() const {
+Cost Edge::getCost() const {
     return cost;
 }
 
+unsigned int Edge::getIndex() const {
+    return index;
+}
+
+void Edge::setIndex(unsigned int index) {
+    Edge::index = index;
+}
 
+unsigned int Edge::getLength() const {
+    return length;
+}
+
+void Edge::setLength(unsigned int length) {
+    Edge::length = length;
+}
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include "vertex.h"
+#include "flowTypes.h"
 
 class Vertex;
 
@@ -18,13 +19,11 @@ enum class Service : unsigned int {
 
 class Edge {
   public:
-    Edge(Vertex *orig, Vertex *dest, unsigned int w, Service s);
+    Edge(Vertex *orig, Vertex *dest, Capacity w, Service s);
 
     [[nodiscard]] Vertex *getDest() const;
 
-    [[nodiscard]] unsigned int getCapacity() const;
-
-    [[nodiscard]] bool isSelected() const; //isOpen
+    [[nodiscard]] Capacity getCapacity() const;
 
     [[nodiscard]] Vertex *getOrig() const;
 
@@ -32,25 +31,31 @@ class Edge {
 
     [[nodiscard]] Service getService() const;
 
-    [[nodiscard]] unsigned int getFlow() const;
+    [[nodiscard]] Capacity getFlow() const;
 
-    [[nodiscard]] int getCost() const;
+    [[nodiscard]] Cost getCost() const;
 
     Edge *getCorrespondingEdge() const;
 
-    void setSelected(bool s);
+    [[nodiscard]] unsigned int getIndex() const;
+
+    [[nodiscard]] unsigned int getLength() const;
 
     void setReverse(Edge *r);
 
     void setService(Service s);
 
-    void setFlow(unsigned int f);
+    void setFlow(Capacity f);
 
-    void setCapacity(unsigned int c);
+    void setCapacity(Capacity c);
 
     void setCorrespondingEdge(Edge *correspondingEdge);
 
-    void setCost(int cost);
+    void setCost(Cost cost);
+
+    void setIndex(unsigned int index);
+
+    void setLength(unsigned int length);
 
     void print() const;
 
@@ -59,18 +64,20 @@ class Edge {
   private:
     Vertex *orig;
     Vertex *dest; // destination vertex
-    unsigned int capacity; // edge capacity
+    Capacity capacity; // edge capacity
     Service service;
 
     // auxiliary fields
-    bool selected = true;
     Edge *reverse = nullptr;
 
     //corresponding edge in the residual/regular graph
     Edge *correspondingEdge = nullptr;
 
-    unsigned int flow = 0; // for flow-related problems
-    int cost;
+    Capacity flow = 0; // for flow-related problems
+    Cost cost;
+
+    unsigned int index = 0; // index of the rail, shared by both directions and by the residual edges
+    unsigned int length = 0; // length of the rail in km, 0 if unknown
 
 };
 
@@ -0,0 +1,149 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "flowCache.h"
+
+bool FlowCache::Key::operator==(const Key &other) const {
+    return kind == other.kind && deactivatedHash == other.deactivatedHash &&
+           topologyVersion == other.topologyVersion && costHash == other.costHash && target == other.target &&
+           sources == other.sources;
+}
+
+std::size_t FlowCache::KeyHash::operator()(const Key &key) const {
+    std::size_t hash = std::hash<std::string>()(key.target);
+    for (const std::string &source: key.sources)
+        hash = hash * 31 + std::hash<std::string>()(source);
+    hash ^= key.deactivatedHash + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    hash ^= key.topologyVersion * 0xBF58476D1CE4E5B9ULL;
+    hash ^= key.costHash * 0x94D049BB133111EBULL;
+    return hash * 3 + (std::size_t) key.kind;
+}
+
+/**
+ * Creates an LRU cache for max flow and min cost results
+ * @param capacity - Maximum number of results kept; the least recently used one is evicted when it is exceeded
+ */
+FlowCache::FlowCache(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+/**
+ * Builds the key identifying a query on the current state of a Graph: the query kind, the set of sources, the target,
+ * the set of deactivated rails, the version of the network's topology and, for min cost queries, the hash of the
+ * rails' costs
+ * Time Complexity: O(s log s), s being the number of sources
+ */
+FlowCache::Key FlowCache::makeKey(QueryKind kind, const std::list<std::string> &source, const std::string &target,
+                                  const Graph &graph) {
+    Key key{kind, std::vector<std::string>(source.begin(), source.end()), target, graph.getDeactivatedHash(),
+            graph.getTopologyVersion(), kind == QueryKind::MIN_COST ? graph.getCostHash() : 0};
+    std::sort(key.sources.begin(), key.sources.end());
+    key.sources.erase(std::unique(key.sources.begin(), key.sources.end()), key.sources.end());
+    return key;
+}
+
+/**
+ * Looks up a result, marking it as the most recently used one
+ * Time Complexity: O(1) (average case)
+ * @return True if the result was cached (and stored in value), false otherwise
+ */
+bool FlowCache::lookup(const Key &key, std::pair<Capacity, Cost> &value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = keyToEntry.find(key);
+    if (it == keyToEntry.end()) {
+        misses++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->second;
+    hits++;
+    return true;
+}
+
+/**
+ * Stores a result as the most recently used one, evicting the least recently used result if the cache is full
+ * Time Complexity: O(1) (average case)
+ */
+void FlowCache::insert(const Key &key, const std::pair<Capacity, Cost> &value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = keyToEntry.find(key);
+    if (it != keyToEntry.end()) { //Computed concurrently by another thread
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    entries.emplace_front(key, value);
+    keyToEntry[key] = entries.begin();
+    if (entries.size() > capacity) {
+        keyToEntry.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+/**
+ * Finds the max flow between the source(s) and the target, only running the max flow algorithm if the same query wasn't
+ * already answered for the current topology and set of deactivated rails. As every engine finds the same value, the
+ * engine and search strategy aren't part of the key. Note that on a cache hit the Edges' flows are not set
+ * Time Complexity: O(1) (cache hit, average case) | That of the chosen engine (cache miss)
+ * @param graph - Graph in which to compute the max flow
+ * @param source - List of ids of the source Vertex(es)
+ * @param target - Id of the target Vertex
+ * @param residualGraph - Graph object representing graph's residual network
+ * @param engine - Max flow algorithm to use on a cache miss
+ * @param search - Strategy used to find the augmenting paths on a cache miss
+ * @return Value of the max flow
+ */
+Capacity FlowCache::maxFlow(Graph &graph, const std::list<std::string> &source, const std::string &target,
+                                Graph &residualGraph, MaxFlowEngine engine, PathSearch search) {
+    Key key = makeKey(QueryKind::MAX_FLOW, source, target, graph);
+    std::pair<Capacity, Cost> value;
+    if (lookup(key, value)) return value.first;
+
+    value.first = graph.maxFlow(source, target, residualGraph, engine, search);
+    insert(key, value);
+    return value.first;
+}
+
+/**
+ * Finds the max flow and its min cost between the source and the target, only running the cycle-cancelling algorithm if
+ * the same query wasn't already answered for the current topology and set of deactivated rails
+ * Time Complexity: O(1) (cache hit, average case) | That of Graph::minCostMaxFlow (cache miss)
+ * @param graph - Graph in which to compute the min cost max flow
+ * @param source - Id of the source Vertex
+ * @param target - Id of the target Vertex
+ * @param residualGraph - Graph object representing graph's residual network
+ * @return A pair representing the value of the max flow and its min cost
+ */
+std::pair<Capacity, Cost>
+FlowCache::minCostMaxFlow(Graph &graph, const std::string &source, const std::string &target, Graph &residualGraph) {
+    Key key = makeKey(QueryKind::MIN_COST, {source}, target, graph);
+    std::pair<Capacity, Cost> value;
+    if (lookup(key, value)) return value;
+
+    value = graph.minCostMaxFlow(source, target, residualGraph);
+    insert(key, value);
+    return value;
+}
+
+unsigned long long FlowCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+unsigned long long FlowCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t FlowCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**
+ * Removes every cached result (the hit and miss counters are kept)
+ * Time Complexity: O(n), n being the number of cached results
+ */
+void FlowCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    keyToEntry.clear();
+}
@@ -0,0 +1,72 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_FLOWCACHE_H
+#define RAILWAYMANAGEMENT_FLOWCACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include "graph.h"
+
+class FlowCache {
+  private:
+    enum class QueryKind : unsigned char {
+        MAX_FLOW, MIN_COST
+    };
+
+    struct Key {
+        QueryKind kind;
+        std::vector<std::string> sources; // sorted, as the order of the sources doesn't change the result
+        std::string target;
+        unsigned long long deactivatedHash;
+        unsigned long long topologyVersion;
+        unsigned long long costHash; // only for min cost queries, as max flows don't depend on the costs
+
+        bool operator==(const Key &other) const;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const;
+    };
+
+    typedef std::pair<Key, std::pair<Capacity, Cost>> Entry;
+
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> keyToEntry;
+    size_t capacity;
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    mutable std::mutex mutex;
+
+    static Key makeKey(QueryKind kind, const std::list<std::string> &source, const std::string &target,
+                       const Graph &graph);
+
+    bool lookup(const Key &key, std::pair<Capacity, Cost> &value);
+
+    void insert(const Key &key, const std::pair<Capacity, Cost> &value);
+
+  public:
+    explicit FlowCache(size_t capacity = 4096);
+
+    Capacity
+    maxFlow(Graph &graph, const std::list<std::string> &source, const std::string &target, Graph &residualGraph,
+            MaxFlowEngine engine = MaxFlowEngine::EDMONDS_KARP, PathSearch search = PathSearch::BFS);
+
+    std::pair<Capacity, Cost>
+    minCostMaxFlow(Graph &graph, const std::string &source, const std::string &target, Graph &residualGraph);
+
+    [[nodiscard]] unsigned long long getHits() const;
+
+    [[nodiscard]] unsigned long long getMisses() const;
+
+    [[nodiscard]] size_t getSize() const;
+
+    void clear();
+};
+
+
+#endif //RAILWAYMANAGEMENT_FLOWCACHE_H
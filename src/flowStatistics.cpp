@@ -0,0 +1,65 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "flowStatistics.h"
+
+/**
+ * Sets every counter and timing back to zero
+ * Time Complexity: O(1)
+ */
+void FlowStatistics::reset() {
+    *this = FlowStatistics();
+}
+
+/**
+ * Adds every counter and timing of another FlowStatistics to this one (e.g. to gather the statistics of worker threads)
+ * Time Complexity: O(1)
+ * @param other - Statistics to add
+ */
+void FlowStatistics::merge(const FlowStatistics &other) {
+    maxFlowRuns += other.maxFlowRuns;
+    pathSearches += other.pathSearches;
+    augmentingPaths += other.augmentingPaths;
+    scalingPhases += other.scalingPhases;
+    warmStarts += other.warmStarts;
+    repairedRails += other.repairedRails;
+    treeReuses += other.treeReuses;
+    orphans += other.orphans;
+    verticesVisited += other.verticesVisited;
+    edgesScanned += other.edgesScanned;
+    bellmanFordPasses += other.bellmanFordPasses;
+    negativeCycles += other.negativeCycles;
+    resetNs += other.resetNs;
+    pathSearchNs += other.pathSearchNs;
+    augmentNs += other.augmentNs;
+    residualBuildNs += other.residualBuildNs;
+    cycleCancellingNs += other.cycleCancellingNs;
+}
+
+/**
+ * Lists every counter and timing (converted to milliseconds) with its name, plus the average number of vertices visited
+ * by a path search, for reports
+ * Time Complexity: O(1)
+ * @return Vector of pairs with the name of the statistic and its value
+ */
+std::vector<std::pair<std::string, double>> FlowStatistics::entries() const {
+    return {{"max_flow_runs",        (double) maxFlowRuns},
+            {"path_searches",        (double) pathSearches},
+            {"augmenting_paths",     (double) augmentingPaths},
+            {"scaling_phases",       (double) scalingPhases},
+            {"warm_starts",          (double) warmStarts},
+            {"repaired_rails",       (double) repairedRails},
+            {"tree_reuses",          (double) treeReuses},
+            {"orphans",              (double) orphans},
+            {"vertices_visited",     (double) verticesVisited},
+            {"edges_scanned",        (double) edgesScanned},
+            {"vertices_per_search",  pathSearches == 0 ? 0 : (double) verticesVisited / (double) pathSearches},
+            {"bellman_ford_passes",  (double) bellmanFordPasses},
+            {"negative_cycles",      (double) negativeCycles},
+            {"reset_ms",             (double) resetNs / 1e6},
+            {"path_search_ms",       (double) pathSearchNs / 1e6},
+            {"augment_ms",           (double) augmentNs / 1e6},
+            {"residual_build_ms",    (double) residualBuildNs / 1e6},
+            {"cycle_cancelling_ms",  (double) cycleCancellingNs / 1e6}};
+}
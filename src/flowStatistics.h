@@ -0,0 +1,81 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_FLOWSTATISTICS_H
+#define RAILWAYMANAGEMENT_FLOWSTATISTICS_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+
+/**
+ * Counters and per-phase timings of the flow algorithms, kept per thread. They are only updated when the project is
+ * built with RAILWAY_FLOW_STATS defined; otherwise the FLOW_STATS_* macros compile to nothing
+ */
+struct FlowStatistics {
+    unsigned long long maxFlowRuns = 0;         // edmondsKarp, capacityScaling, warmMaxFlow and boykovKolmogorov calls
+    unsigned long long pathSearches = 0;        // passes of Graph::path and Graph::bidirectionalPath
+    unsigned long long augmentingPaths = 0;
+    unsigned long long scalingPhases = 0;       // values of delta tried by capacityScaling
+    unsigned long long warmStarts = 0;          // warmMaxFlow calls that reused the previous flow
+    unsigned long long repairedRails = 0;       // deactivated rails whose flow warmMaxFlow cancelled
+    unsigned long long treeReuses = 0;          // boykovKolmogorov calls that reused the previous search trees
+    unsigned long long orphans = 0;             // vertices cut off from a boykovKolmogorov search tree
+    unsigned long long verticesVisited = 0;     // vertices reached by the path searches
+    unsigned long long edgesScanned = 0;        // edges looked at by the path searches
+    unsigned long long bellmanFordPasses = 0;
+    unsigned long long negativeCycles = 0;      // negative cycles cancelled by minCostMaxFlow
+
+    unsigned long long resetNs = 0;             // resetting flows and residual capacities
+    unsigned long long pathSearchNs = 0;
+    unsigned long long augmentNs = 0;           // finding bottlenecks and augmenting paths
+    unsigned long long residualBuildNs = 0;     // building the min cost residual network
+    unsigned long long cycleCancellingNs = 0;   // Bellman-Ford searches and negative cycle cancelling
+
+    static constexpr bool enabled() {
+#ifdef RAILWAY_FLOW_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void reset();
+
+    void merge(const FlowStatistics &other);
+
+    [[nodiscard]] std::vector<std::pair<std::string, double>> entries() const;
+};
+
+inline thread_local FlowStatistics flowStatistics;
+
+/**
+ * Adds the time elapsed between its construction and destruction to a FlowStatistics timing field
+ */
+class PhaseTimer {
+  private:
+    unsigned long long &target;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+    explicit PhaseTimer(unsigned long long &target) : target(target), start(std::chrono::steady_clock::now()) {}
+
+    ~PhaseTimer() {
+        target += (unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+#ifdef RAILWAY_FLOW_STATS
+#define FLOW_STATS_CONCAT_(a, b) a##b
+#define FLOW_STATS_CONCAT(a, b) FLOW_STATS_CONCAT_(a, b)
+#define FLOW_STATS_ADD(counter, amount) (flowStatistics.counter += (amount))
+#define FLOW_STATS_TIMER(phase) PhaseTimer FLOW_STATS_CONCAT(phaseTimer, __LINE__)(flowStatistics.phase)
+#else
+#define FLOW_STATS_ADD(counter, amount) ((void) 0)
+#define FLOW_STATS_TIMER(phase) ((void) 0)
+#endif
+
+#endif //RAILWAYMANAGEMENT_FLOWSTATISTICS_H
@@ -0,0 +1,27 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_FLOWTYPES_H
+#define RAILWAYMANAGEMENT_FLOWTYPES_H
+
+#include <limits>
+
+/**
+ * Numeric types of the flow algorithms, fixed at compile time. Capacities and flows are 32 bit by default and 64 bit
+ * when the project is built with RAILWAY_WIDE_CAPACITY defined, costs are always signed 64 bit and sums of flows over
+ * many stations or rails use FlowSum, so that national totals cannot overflow
+ */
+#ifdef RAILWAY_WIDE_CAPACITY
+using Capacity = unsigned long long;
+#else
+using Capacity = unsigned int;
+#endif
+
+using Cost = long long;
+using FlowSum = unsigned long long;
+
+constexpr Capacity INFINITE_CAPACITY = std::numeric_limits<Capacity>::max();
+constexpr Cost INFINITE_COST = std::numeric_limits<Cost>::max();
+
+#endif //RAILWAYMANAGEMENT_FLOWTYPES_H
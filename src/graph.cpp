@@ -3,10 +3,23 @@
 //
 
 #include "graph.h"
+#include "threadPool.h"
+#include <deque>
 
 
 Graph::Graph() = default;
 
+/**
+ * Frees every Vertex and Edge of the Graph
+ * Time Complexity: O(|V|+|E|)
+ */
+Graph::~Graph() {
+    for (Vertex *v: vertexSet) {
+        for (Edge *e: v->getAdj()) delete e;
+        delete v;
+    }
+}
+
 unsigned int Graph::getNumVertex() const {
     return (unsigned int) vertexSet.size();
 }
@@ -20,6 +33,32 @@ unsigned int Graph::getTotalEdges() const {
     return totalEdges;
 }
 
+unsigned long long Graph::getTopologyVersion() const {
+    return topologyVersion;
+}
+
+unsigned long long Graph::getDeactivatedHash() const {
+    return deactivatedHash;
+}
+
+unsigned long long Graph::getCostHash() const {
+    return costHash;
+}
+
+/**
+ * Mixes the index of a rail into a well-distributed 64-bit hash (splitmix64 finalizer), so that XOR-ing the hashes of a
+ * set of rails gives an order-independent hash of the set
+ * Time Complexity: O(1)
+ * @param index - Index of the rail
+ * @return Hash of the rail
+ */
+unsigned long long Graph::railHash(unsigned int index) {
+    unsigned long long x = index + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
 /**
  * Finds the vertex with a given id
  * Time Complexity: O(1) (average case) | O(|V|) (worst case)
@@ -42,7 +81,9 @@ bool Graph::addVertex(const std::string &id) {
     if (findVertex(id) != nullptr)
         return false;
     vertexSet.push_back(new Vertex(id));
+    vertexSet.back()->setIndex((unsigned int) vertexSet.size() - 1);
     idToVertex[id] = vertexSet.back();
+    topologyVersion++;
     return true;
 }
 
@@ -53,10 +94,12 @@ bool Graph::addVertex(const std::string &id) {
  * @param dest - Id of the destination Vertex
  * @param c - Capacity of the Edge to be added
  * @param service - Service of the Edge to be added
+ * @param length - Length of the rail in km (0 if unknown)
  * @return Pair containing a pointer to the created Edge and to its reverse
  */
 std::pair<Edge *, Edge *>
-Graph::addAndGetBidirectionalEdge(const std::string &source, const std::string &dest, unsigned int c, Service service) {
+Graph::addAndGetBidirectionalEdge(const std::string &source, const std::string &dest, Capacity c, Service service,
+                                  unsigned int length) {
     auto v1 = findVertex(source);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
@@ -66,11 +109,71 @@ Graph::addAndGetBidirectionalEdge(const std::string &source, const std::string &
     auto e2 = v2->addEdge(v1, c, service);
     e1->setReverse(e2);
     e2->setReverse(e1);
-
+    e1->setIndex(totalEdges);
+    e2->setIndex(totalEdges);
+    e1->setLength(length);
+    e2->setLength(length);
+
+    edgeSet.push_back(e1);
+    if (activeRails->size() * 64 <= totalEdges) activeRails->push_back(0); // may have grown through a shared Graph
+    (*activeRails)[totalEdges / 64] |= 1ULL << (totalEdges % 64);
     totalEdges++;
+    topologyVersion++;
     return {e1, e2};
 }
 
+/**
+ * Builds in graphCopy and residualCopy an independent copy of this Graph and of its residual network, with the same
+ * vertex and edge order, capacities, services, lengths, costs and deactivated rails. Both copies should be empty
+ * Time Complexity: O(|V|+|E|) (average case)
+ * @param graphCopy - Graph object in which to build the copy of this Graph
+ * @param residualCopy - Graph object in which to build the copy of the residual network
+ */
+void Graph::copyNetwork(Graph &graphCopy, Graph &residualCopy) const {
+    for (Vertex const *v: vertexSet) {
+        graphCopy.addVertex(v->getId());
+        residualCopy.addVertex(v->getId());
+    }
+    for (Edge const *e: edgeSet) {
+        std::string orig = e->getOrig()->getId();
+        std::string dest = e->getDest()->getId();
+        auto [regular, regularReverse] = graphCopy.addAndGetBidirectionalEdge(orig, dest, e->getCapacity(),
+                                                                              e->getService(), e->getLength());
+        auto [residual, residualReverse] = residualCopy.addAndGetBidirectionalEdge(orig, dest, e->getCapacity(),
+                                                                                  e->getService(), e->getLength());
+        regular->setCorrespondingEdge(residual);
+        regularReverse->setCorrespondingEdge(residualReverse);
+        residual->setCorrespondingEdge(regular);
+        residualReverse->setCorrespondingEdge(regularReverse);
+
+        regular->setCost(e->getCost());
+        regularReverse->setCost(e->getReverse()->getCost());
+    }
+    *graphCopy.activeRails = *activeRails;
+    graphCopy.shareRailActivation(residualCopy);
+    graphCopy.deactivatedHash = deactivatedHash;
+    graphCopy.topologyVersion = topologyVersion;
+    residualCopy.topologyVersion = topologyVersion;
+    graphCopy.costHash = costHash;
+}
+
+/**
+ * Sets the cost of every rail (in both directions) from the cost of its service, so that min cost queries can be
+ * answered under another tariff without rebuilding the network. The costs are also hashed (FNV-1a over the rails), so
+ * that applying the same tariff again, e.g. restoring the default one, gives back the same hash
+ * Time Complexity: O(|E|)
+ * @param costModel - Costs of the services
+ */
+void Graph::applyCostModel(const ServiceCostModel &costModel) {
+    costHash = 0xCBF29CE484222325ULL;
+    for (Edge *rail: edgeSet) {
+        Cost cost = costModel.getCost(rail->getService(), rail->getLength());
+        rail->setCost(cost);
+        rail->getReverse()->setCost(cost);
+        costHash = (costHash ^ (unsigned long long) cost) * 0x100000001B3ULL;
+    }
+}
+
 /**
  * Single-source or Multi-source Edmonds-Karp algorithm to find the the network's max flow
  * Time Complexity: O(|VE²|)
@@ -79,22 +182,37 @@ Graph::addAndGetBidirectionalEdge(const std::string &source, const std::string &
  * @param residualGraph - Graph object representing this Graph's residual network
  * @return unsigned int representing computed value of max flow
  */
+Capacity Graph::edmondsKarp(const std::list<std::string> &source, const std::string &target, Graph &residualGraph) {
+    std::vector<unsigned int> sourceIndexes;
+    for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+    return edmondsKarp(sourceIndexes, findVertex(target)->getIndex(), residualGraph);
+}
 
-unsigned int Graph::edmondsKarp(const std::list<std::string> &source, const std::string &target, Graph &residualGraph) {
-    for (Vertex const *v: vertexSet) {
-        for (Edge *e: v->getAdj()) {
-            e->setFlow(0);
-            e->getCorrespondingEdge()->setCapacity(e->getCapacity()); //Reset residual edge capacity
-        }
-    }
+/**
+ * Single-source or Multi-source Edmonds-Karp algorithm to find the the network's max flow, with the vertices given by their
+ * index. The sources act as a virtual super source (the target is skipped if it is also in the list)
+ * Time Complexity: O(|VE²|)
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param search - Strategy used to find the augmenting paths
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity
+Graph::edmondsKarp(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                   PathSearch search) {
+    FLOW_STATS_ADD(maxFlowRuns, 1);
+    resetFlows();
 
     // Initialize the maximum flow to 0
-    unsigned int maxFlow = 0;
+    Capacity maxFlow = 0;
 
-    while (residualGraph.path(source, target)) {
+    while (residualGraph.augmentingPath(source, target, 1, search)) {
+        FLOW_STATS_TIMER(augmentNs);
+        FLOW_STATS_ADD(augmentingPaths, 1);
 
         // Find the bottleneck capacity of the path
-        unsigned int bottleneckCapacity = residualGraph.findBottleneck(target);
+        Capacity bottleneckCapacity = residualGraph.findBottleneck(target);
 
         // Augment the flow by the bottleneck capacity
         residualGraph.augmentPath(target, bottleneckCapacity);
@@ -106,49 +224,934 @@ unsigned int Graph::edmondsKarp(const std::list<std::string> &source, const std:
 }
 
 /**
- * Adapted BFS that checks if there is a valid path connecting the source and target vertices. Indicated for use on residual graphs
+ * Capacity scaling variant of the augmenting path algorithm: only residual edges with at least delta available capacity
+ * are used, delta starting at the largest power of two not above the largest rail capacity and being halved whenever no
+ * more such paths exist. Large augmentations are thus done first, avoiding many small ones on networks with very
+ * different capacities
+ * Time Complexity: O(|E|² log(U)), U being the largest capacity
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param search - Strategy used to find the augmenting paths
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity
+Graph::capacityScaling(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                       PathSearch search) {
+    FLOW_STATS_ADD(maxFlowRuns, 1);
+    resetFlows();
+
+    Capacity maxCapacity = 0;
+    for (Edge const *e: edgeSet)
+        if (isRailActive(e->getIndex())) maxCapacity = std::max(maxCapacity, e->getCapacity());
+
+    Capacity delta = 1;
+    while (delta <= maxCapacity / 2) delta *= 2;
+
+    Capacity maxFlow = 0;
+    for (; delta > 0 && maxCapacity > 0; delta /= 2) {
+        FLOW_STATS_ADD(scalingPhases, 1);
+        while (residualGraph.augmentingPath(source, target, delta, search)) {
+            FLOW_STATS_TIMER(augmentNs);
+            FLOW_STATS_ADD(augmentingPaths, 1);
+
+            Capacity bottleneckCapacity = residualGraph.findBottleneck(target);
+            residualGraph.augmentPath(target, bottleneckCapacity);
+            maxFlow += bottleneckCapacity;
+        }
+    }
+    return maxFlow;
+}
+
+/**
+ * Computes the max flow between the source(s) and the target with the chosen algorithm
+ * Time Complexity: That of the chosen algorithm
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param engine - Algorithm to use
+ * @param search - Strategy used to find the augmenting paths
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity Graph::maxFlow(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                            MaxFlowEngine engine, PathSearch search) {
+    switch (engine) {
+        case MaxFlowEngine::CAPACITY_SCALING:
+            return capacityScaling(source, target, residualGraph, search);
+        case MaxFlowEngine::BOYKOV_KOLMOGOROV:
+            return boykovKolmogorov(source, target, residualGraph);
+        case MaxFlowEngine::EDMONDS_KARP:
+        default:
+            return edmondsKarp(source, target, residualGraph, search);
+    }
+}
+
+/**
+ * Computes the max flow between the source(s) and the target with the chosen algorithm
+ * Time Complexity: That of the chosen algorithm
+ * @param source - List of ids of the source Vertex(es)
+ * @param target - Id of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param engine - Algorithm to use
+ * @param search - Strategy used to find the augmenting paths
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity Graph::maxFlow(const std::list<std::string> &source, const std::string &target, Graph &residualGraph,
+                            MaxFlowEngine engine, PathSearch search) {
+    std::vector<unsigned int> sourceIndexes;
+    for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+    return maxFlow(sourceIndexes, findVertex(target)->getIndex(), residualGraph, engine, search);
+}
+
+/**
+ * Computes the max flow from a set of source stations to a set of sink stations, each with a supply or demand cap, with
+ * the chosen algorithm. The caps are the capacities of virtual arcs from a super source and to a super sink (see
+ * TerminalArcs), which aren't added to the Graph: Edmonds-Karp and capacity scaling search paths from every source with
+ * supply left to the nearest sink with demand left, and Boykov-Kolmogorov roots its trees at them
+ * Time Complexity: That of the chosen algorithm
+ * @param sources - Source Vertex(es) and their supply (INFINITE_CAPACITY if unbounded)
+ * @param sinks - Sink Vertex(es) and their demand (INFINITE_CAPACITY if unbounded)
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param engine - Algorithm to use
+ * @return MultiTerminalFlow with the value of the max flow and the flow of each distinct source and sink (with their
+ * total supply or demand, if repeated)
+ */
+MultiTerminalFlow Graph::multiTerminalMaxFlow(const std::vector<TerminalFlow> &sources,
+                                              const std::vector<TerminalFlow> &sinks, Graph &residualGraph,
+                                              MaxFlowEngine engine) {
+    FLOW_STATS_ADD(maxFlowRuns, 1);
+    resetFlows();
+
+    TerminalArcs terminals(vertexSet.size());
+    for (const TerminalFlow &source: sources) terminals.addSource(source.vertex, source.capacity);
+    for (const TerminalFlow &sink: sinks) terminals.addSink(sink.vertex, sink.capacity);
+
+    MultiTerminalFlow result;
+    auto distinct = [](const std::vector<TerminalFlow> &list, std::vector<TerminalFlow> &into, auto capacityOf) {
+        std::unordered_set<unsigned int> seen;
+        for (const TerminalFlow &terminal: list)
+            if (seen.insert(terminal.vertex).second) into.push_back({terminal.vertex, capacityOf(terminal.vertex), 0});
+    };
+    distinct(sources, result.sources, [&](unsigned int v) { return terminals.getSupply(v); });
+    distinct(sinks, result.sinks, [&](unsigned int v) { return terminals.getDemand(v); });
+
+    result.value = terminals.connectTerminals();
+    if (engine == MaxFlowEngine::BOYKOV_KOLMOGOROV) {
+        result.value += growSearchTrees(residualGraph, terminals, false);
+    } else {
+        Capacity delta = 1;
+        if (engine == MaxFlowEngine::CAPACITY_SCALING) {
+            Capacity maxCapacity = 0;
+            for (Edge const *e: edgeSet)
+                if (isRailActive(e->getIndex())) maxCapacity = std::max(maxCapacity, e->getCapacity());
+            while (delta <= maxCapacity / 2) delta *= 2;
+        }
+        unsigned int sink;
+        for (; delta > 0; delta /= 2) {
+            FLOW_STATS_ADD(scalingPhases, engine == MaxFlowEngine::CAPACITY_SCALING);
+            while (residualGraph.terminalPath(terminals, delta, sink)) {
+                FLOW_STATS_TIMER(augmentNs);
+                FLOW_STATS_ADD(augmentingPaths, 1);
+                result.value += residualGraph.augmentTerminalPath(sink, terminals);
+            }
+        }
+    }
+
+    for (TerminalFlow &source: result.sources) source.flow = terminals.getSupplied(source.vertex);
+    for (TerminalFlow &sink: result.sinks) sink.flow = terminals.getDelivered(sink.vertex);
+    return result;
+}
+
+/**
+ * Approximates the max concurrent flow of several origin-destination demands competing for the same rails (see
+ * MultiCommodityFlow), after computing the max flow of each pair on its own
+ * Time Complexity: O(k|VE²|) for the max flows, plus that of MultiCommodityFlow::solve
+ * @param commodities - Origin-destination pairs and their demands
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param epsilon - Approximation parameter (between 0 and 1): smaller is more precise but slower
+ * @return ConcurrentFlow with the fraction of every demand that can be routed at the same time and the flow of each pair
+ */
+ConcurrentFlow Graph::maxConcurrentFlow(const std::vector<Commodity> &commodities, Graph &residualGraph,
+                                        double epsilon) {
+    std::vector<double> soloFlows;
+    for (const Commodity &commodity: commodities) {
+        std::vector<unsigned int> source = {commodity.source};
+        soloFlows.push_back(commodity.source == commodity.target ? 0 : edmondsKarp(source, commodity.target,
+                                                                                   residualGraph));
+    }
+    return MultiCommodityFlow(*this).solve(commodities, soloFlows, epsilon);
+}
+
+/**
+ * Sorts a list of sources, removing repeated ones and the target
+ * Time Complexity: O(s log(s)), s being the number of sources
+ */
+std::vector<unsigned int> distinctSources(const std::vector<unsigned int> &source, unsigned int target) {
+    std::vector<unsigned int> sortedSource;
+    for (unsigned int s: source) if (s != target) sortedSource.push_back(s);
+    std::sort(sortedSource.begin(), sortedSource.end());
+    sortedSource.erase(std::unique(sortedSource.begin(), sortedSource.end()), sortedSource.end());
+    return sortedSource;
+}
+
+/**
+ * Splits the flow left in the edges by the last max flow computed between the source(s) and the target into paths,
+ * each going from a source to the target with a number of trains. Each path is found by walking from a source along
+ * edges with undecomposed flow (each vertex remembers the first of its edges that may still have some), and takes away
+ * the bottleneck of its edges, so at most |E| + s paths are produced. Flow cycles found during a walk carry no trains
+ * between the stations and are cancelled. Doesn't run any max flow algorithm
+ * Time Complexity: O(|V|+|E|+|E|p), p being the number of paths
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @return The value of the flow, every edge carrying flow with its flow, and the paths
+ */
+FlowDecomposition Graph::decomposeFlow(const std::vector<unsigned int> &source, unsigned int target) const {
+    FlowDecomposition decomposition;
+    std::vector<Capacity> remaining(2 * edgeSet.size(), 0); // per direction of each rail
+    auto slot = [this](Edge const *e) { return 2 * e->getIndex() + (edgeSet[e->getIndex()] == e ? 0 : 1); };
+
+    for (Vertex const *v: vertexSet) {
+        for (Edge *e: v->getAdj()) {
+            if (e->getFlow() == 0) continue;
+            remaining[slot(e)] = e->getFlow();
+            decomposition.edgeFlows.emplace_back(e, e->getFlow());
+        }
+    }
+    long long value = 0;
+    for (Edge const *e: vertexSet[target]->getIncoming()) value += e->getFlow();
+    for (Edge const *e: vertexSet[target]->getAdj()) value -= e->getFlow();
+    decomposition.value = (Capacity) std::max(0LL, value);
+
+    std::vector<size_t> nextEdge(vertexSet.size(), 0);
+    std::vector<int> position(vertexSet.size(), -1); // number of path edges before reaching each vertex on the path
+    std::vector<Edge *> path;
+
+    for (unsigned int s: distinctSources(source, target)) {
+        // Only the flow the source supplies leaves it, the rest belongs to paths from other sources passing through it
+        long long excess = 0;
+        for (Edge const *e: vertexSet[s]->getAdj()) excess += e->getFlow();
+        for (Edge const *e: vertexSet[s]->getIncoming()) excess -= e->getFlow();
+
+        while (excess > 0) {
+            path.clear();
+            position[s] = 0;
+            unsigned int v = s;
+            bool stuck = false;
+
+            while (v != target) {
+                const std::vector<Edge *> &adj = vertexSet[v]->getAdj();
+                while (nextEdge[v] < adj.size() && remaining[slot(adj[nextEdge[v]])] == 0) nextEdge[v]++;
+                if (nextEdge[v] == adj.size()) {
+                    stuck = true; // only possible if the flow isn't a valid flow between source and target
+                    break;
+                }
+                Edge *e = adj[nextEdge[v]];
+                unsigned int w = e->getDest()->getIndex();
+                path.push_back(e);
+                if (position[w] == -1) {
+                    position[w] = (int) path.size();
+                    v = w;
+                    continue;
+                }
+
+                // Flow cycle back to w: cancel it and resume the walk from w
+                Capacity cycleFlow = INFINITE_CAPACITY;
+                for (size_t i = position[w]; i < path.size(); i++)
+                    cycleFlow = std::min(cycleFlow, remaining[slot(path[i])]);
+                for (size_t i = position[w]; i < path.size(); i++) {
+                    remaining[slot(path[i])] -= cycleFlow;
+                    if (path[i]->getDest()->getIndex() != w) position[path[i]->getDest()->getIndex()] = -1;
+                }
+                path.resize(position[w]);
+                v = w;
+            }
+
+            auto trains = (Capacity) std::min<unsigned long long>(excess, INFINITE_CAPACITY);
+            for (Edge *e: path) trains = std::min(trains, remaining[slot(e)]);
+            for (Edge *e: path) position[e->getDest()->getIndex()] = -1;
+            position[s] = -1;
+            if (stuck) break;
+
+            for (Edge *e: path) remaining[slot(e)] -= trains;
+            decomposition.paths.push_back({path, trains});
+            excess -= trains;
+        }
+    }
+    return decomposition;
+}
+
+/**
+ * Computes the max flow between the source(s) and the target with the chosen algorithm, and decomposes it into paths
+ * (see decomposeFlow)
+ * Time Complexity: That of the chosen algorithm, plus that of decomposeFlow
+ * @param source - List of ids of the source Vertex(es)
+ * @param target - Id of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param engine - Algorithm to use
+ * @param search - Strategy used to find the augmenting paths
+ * @return The value of the max flow, every edge carrying flow with its flow, and the paths
+ */
+FlowDecomposition Graph::maxFlowDecomposition(const std::list<std::string> &source, const std::string &target,
+                                              Graph &residualGraph, MaxFlowEngine engine, PathSearch search) {
+    std::vector<unsigned int> sourceIndexes;
+    for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+    unsigned int targetIndex = findVertex(target)->getIndex();
+    maxFlow(sourceIndexes, targetIndex, residualGraph, engine, search);
+    return decomposeFlow(sourceIndexes, targetIndex);
+}
+
+/**
+ * Sets the flow of every edge to 0 and the capacity of every residual edge back to that of its corresponding edge
+ * Time Complexity: O(|V|+|E|)
+ */
+void Graph::resetFlows() {
+    FLOW_STATS_TIMER(resetNs);
+    flowResets++;
+    for (Vertex const *v: vertexSet) {
+        for (Edge *e: v->getAdj()) {
+            e->setFlow(0);
+            e->getCorrespondingEdge()->setCapacity(e->getCapacity()); //Reset residual edge capacity
+        }
+    }
+}
+
+/**
+ * Edmonds-Karp variation that starts from the flow left by the previous call, instead of from an empty flow, when the
+ * sources, the target and the topology are the same and no other algorithm changed the flows in between. Rails
+ * deactivated since then have their flow cancelled, and the flow is made feasible again by sending the resulting
+ * excesses through the residual network (see restoreConservation). Then (and also for rails activated since then,
+ * which start with no flow) only the missing augmenting paths are searched for
+ * Time Complexity: O(|VE²|) (worst case) | O(a|E|) (warm start), a being the number of augmentations needed to repair
+ * the previous flow
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param search - Strategy used to find the augmenting paths
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity Graph::warmMaxFlow(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                                PathSearch search) {
+    FLOW_STATS_ADD(maxFlowRuns, 1);
+    std::vector<unsigned int> sortedSource = distinctSources(source, target);
+    reuseWarmFlow(sortedSource, target, residualGraph);
+
+    while (residualGraph.augmentingPath(sortedSource, target, 1, search)) {
+        FLOW_STATS_TIMER(augmentNs);
+        FLOW_STATS_ADD(augmentingPaths, 1);
+        residualGraph.augmentPath(target, residualGraph.findBottleneck(target));
+    }
+
+    warmStart.hasTrees = false;
+    return recordWarmFlow(sortedSource, target, residualGraph);
+}
+
+/**
+ * Prepares the flow a warm-started algorithm starts from: if the flow left by the previous warm-started call was for the
+ * same sources, target, topology and residual network, and wasn't overwritten since, the flow of the rails deactivated
+ * since then is cancelled and conservation is restored; otherwise every flow is reset
+ * Time Complexity: O(|V| + |E|/64 + d) plus that of restoreConservation, d being the number of rails deactivated since
+ * @param sortedSource - Indexes of the source Vertex(es), sorted and without the target
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @return True if the previous flow was reused, false if the flows were reset
+ */
+bool Graph::reuseWarmFlow(const std::vector<unsigned int> &sortedSource, unsigned int target, Graph &residualGraph) {
+    bool reusable = warmStart.valid && warmStart.residualGraph == &residualGraph && warmStart.source == sortedSource &&
+                    warmStart.target == target && warmStart.topologyVersion == topologyVersion &&
+                    warmStart.flowResets == flowResets;
+    if (!reusable) {
+        resetFlows();
+        return false;
+    }
+
+    FLOW_STATS_ADD(warmStarts, 1);
+    std::vector<bool> terminal(vertexSet.size(), false);
+    for (unsigned int s: sortedSource) terminal[s] = true;
+    terminal[target] = true;
+    std::vector<long long> imbalance(vertexSet.size(), 0);
+
+    const std::vector<unsigned long long> &active = *activeRails;
+    for (unsigned int word = 0; word < active.size(); word++) {
+        unsigned long long deactivated = warmStart.activeRails[word] & ~active[word]; // rails deactivated since then
+        if (deactivated == 0) continue;
+        for (unsigned int bit = 0; bit < 64; bit++) {
+            if (((deactivated >> bit) & 1) == 0) continue;
+            Edge *rail = edgeSet[word * 64 + bit];
+            Edge *reverse = rail->getReverse();
+            Edge *loaded = rail->getFlow() > 0 ? rail : reverse; // after augmentPath, at most one direction has flow
+            Capacity flow = loaded->getFlow();
+            rail->setFlow(0);
+            reverse->setFlow(0);
+            rail->getCorrespondingEdge()->setCapacity(rail->getCapacity());
+            reverse->getCorrespondingEdge()->setCapacity(reverse->getCapacity());
+            if (flow == 0) continue;
+
+            FLOW_STATS_ADD(repairedRails, 1);
+            imbalance[loaded->getOrig()->getIndex()] += flow;
+            imbalance[loaded->getDest()->getIndex()] -= flow;
+        }
+    }
+    residualGraph.restoreConservation(imbalance, terminal, sortedSource, target);
+    return true;
+}
+
+/**
+ * Remembers what the current flow was computed for, so that the next warm-started call can reuse it, and measures it
+ * Time Complexity: O(|E|)
+ * @param sortedSource - Indexes of the source Vertex(es), sorted and without the target
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @return Value of the flow, measured at the target
+ */
+Capacity
+Graph::recordWarmFlow(const std::vector<unsigned int> &sortedSource, unsigned int target, Graph &residualGraph) {
+    long long maxFlow = 0;
+    for (Edge const *e: vertexSet[target]->getIncoming()) maxFlow += e->getFlow();
+    for (Edge const *e: vertexSet[target]->getAdj()) maxFlow -= e->getFlow();
+
+    warmStart.valid = true;
+    warmStart.residualGraph = &residualGraph;
+    warmStart.source = sortedSource;
+    warmStart.target = target;
+    warmStart.topologyVersion = topologyVersion;
+    warmStart.flowResets = flowResets;
+    warmStart.activeRails = *activeRails;
+    return (Capacity) std::max(0LL, maxFlow);
+}
+
+/**
+ * Boykov-Kolmogorov max flow algorithm. A search tree grows from the sources and another one (over incoming edges) from
+ * the target; when they touch, the path through both trees is augmented, and the vertices cut off from their tree by
+ * saturated edges (orphans) look for a new parent in the same tree, or are freed (see growSearchTrees).
+ * Unlike Edmonds-Karp, the trees are kept between augmentations instead of being searched again from scratch.
+ * With reuseTrees, the flow and the trees left by the previous warm-started call (see warmMaxFlow) are reused when the
+ * query is the same: the tree edges made unusable by rails deactivated in between are cut and repaired like orphans,
+ * and every tree vertex is made active so that the trees also grow through reactivated rails
+ * Time Complexity: O(|V|²|E||C|) (worst case), C being the value of the max flow; usually much faster in practice
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param reuseTrees - Whether to start from the flow and trees of the previous warm-started call
+ * @return unsigned int representing computed value of max flow
+ */
+Capacity Graph::boykovKolmogorov(const std::vector<unsigned int> &source, unsigned int target,
+                                     Graph &residualGraph, bool reuseTrees) {
+    FLOW_STATS_ADD(maxFlowRuns, 1);
+    std::vector<unsigned int> sortedSource = distinctSources(source, target);
+
+    bool reused = false;
+    if (reuseTrees) reused = reuseWarmFlow(sortedSource, target, residualGraph) && warmStart.hasTrees;
+    else resetFlows();
+
+    TerminalArcs terminals(vertexSet.size());
+    for (unsigned int s: sortedSource) terminals.addSource(s);
+    terminals.addSink(target);
+    growSearchTrees(residualGraph, terminals, reused);
+
+    warmStart.hasTrees = true;
+    return recordWarmFlow(sortedSource, target, residualGraph);
+}
+
+/**
+ * Search tree phase of the Boykov-Kolmogorov algorithm, shared by the single-target and the multi-terminal versions.
+ * The source tree is rooted at the vertices with supply left and the target tree at the vertices with demand left (no
+ * vertex may have both, see TerminalArcs::connectTerminals). Each augmentation is limited by the supply and demand
+ * left at the ends of its path, and a root whose supply or demand runs out becomes an orphan of its own tree
+ * Time Complexity: O(|V|²|E||C|) (worst case), C being the value of the max flow; usually much faster in practice
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param terminals - Virtual arcs of the sources and sinks, updated with the flow sent through them
+ * @param reused - Whether to start from the trees stored in the warm start, for the same terminals
+ * @return Flow sent from the sources to the sinks
+ */
+Capacity Graph::growSearchTrees(Graph &residualGraph, TerminalArcs &terminals, bool reused) {
+    enum : unsigned char {
+        FREE = 0, SOURCE_TREE = 1, TARGET_TREE = 2
+    };
+    const std::vector<Vertex *> &vertices = residualGraph.vertexSet;
+    const size_t numVertices = vertices.size();
+
+    std::vector<unsigned char> &tree = warmStart.tree;
+    std::vector<Edge *> &parent = warmStart.parent; // edge from the parent (source tree) or to the parent (target tree)
+    std::vector<bool> root(numVertices, false);
+    for (unsigned int v = 0; v < numVertices; v++)
+        root[v] = terminals.getSupply(v) > 0 || terminals.getDemand(v) > 0;
+
+    std::deque<unsigned int> active;
+    std::vector<unsigned int> orphans;
+    auto usable = [&](Edge const *e) { return isRailActive(e->getIndex()) && e->getCapacity() > 0; };
+    auto parentOf = [&](unsigned int v) {
+        return tree[v] == SOURCE_TREE ? parent[v]->getOrig()->getIndex() : parent[v]->getDest()->getIndex();
+    };
+
+    if (reused) {
+        FLOW_STATS_ADD(treeReuses, 1);
+        // Cut the tree edges that can't be used anymore, and let every tree vertex grow again
+        for (unsigned int v = 0; v < numVertices; v++) {
+            if (tree[v] == FREE || root[v]) continue;
+            if (parent[v] == nullptr || !usable(parent[v]) || tree[parentOf(v)] != tree[v]) {
+                parent[v] = nullptr;
+                orphans.push_back(v);
+            }
+        }
+        for (unsigned int v = 0; v < numVertices; v++) if (tree[v] != FREE) active.push_back(v);
+    } else {
+        tree.assign(numVertices, FREE);
+        parent.assign(numVertices, nullptr);
+        for (unsigned int v = 0; v < numVertices; v++) {
+            if (!root[v]) continue;
+            tree[v] = terminals.getSupply(v) > 0 ? SOURCE_TREE : TARGET_TREE;
+            active.push_back(v);
+        }
+    }
+    for (unsigned int v = 0; v < numVertices; v++) if (root[v]) parent[v] = nullptr;
+    Capacity flow = 0;
+
+    // Marks used to check the origin of candidate parents quickly: vertices checked at time stamp[v] are at distance[v]
+    // from their tree's root
+    std::vector<unsigned long long> stamp(numVertices, 0);
+    std::vector<unsigned int> distance(numVertices, 0);
+    unsigned long long time = 1;
+
+    auto adopt = [&]() {
+        while (!orphans.empty()) {
+            unsigned int p = orphans.back();
+            orphans.pop_back();
+            FLOW_STATS_ADD(orphans, 1);
+            unsigned char t = tree[p];
+            const std::vector<Edge *> &candidates = t == SOURCE_TREE ? vertices[p]->getIncoming()
+                                                                     : vertices[p]->getAdj();
+            Edge *bestEdge = nullptr;
+            unsigned int bestDistance = UINT32_MAX;
+
+            for (Edge *e: candidates) {
+                if (!usable(e)) continue;
+                unsigned int q = t == SOURCE_TREE ? e->getOrig()->getIndex() : e->getDest()->getIndex();
+                if (tree[q] != t) continue;
+
+                unsigned int d = 0;
+                unsigned int j = q;
+                while (true) {
+                    if (stamp[j] == time) {
+                        d += distance[j];
+                        break;
+                    }
+                    d++;
+                    if (root[j]) {
+                        stamp[j] = time;
+                        distance[j] = 1;
+                        break;
+                    }
+                    if (parent[j] == nullptr) {
+                        d = UINT32_MAX;
+                        break;
+                    }
+                    j = parentOf(j);
+                }
+                if (d == UINT32_MAX) continue;
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    bestEdge = e;
+                }
+                for (j = q; stamp[j] != time; j = parentOf(j)) {
+                    stamp[j] = time;
+                    distance[j] = d--;
+                }
+            }
+
+            if (bestEdge != nullptr) {
+                parent[p] = bestEdge;
+                stamp[p] = time;
+                distance[p] = bestDistance + 1;
+                continue;
+            }
+
+            // No valid parent: p leaves the tree, its children become orphans and its neighbours may grow into it
+            for (Edge *e: candidates) {
+                unsigned int q = t == SOURCE_TREE ? e->getOrig()->getIndex() : e->getDest()->getIndex();
+                if (tree[q] == t && usable(e)) active.push_back(q);
+            }
+            const std::vector<Edge *> &children = t == SOURCE_TREE ? vertices[p]->getAdj() : vertices[p]->getIncoming();
+            for (Edge *e: children) {
+                unsigned int q = t == SOURCE_TREE ? e->getDest()->getIndex() : e->getOrig()->getIndex();
+                if (tree[q] == t && parent[q] == e) {
+                    parent[q] = nullptr;
+                    orphans.push_back(q);
+                }
+            }
+            tree[p] = FREE;
+        }
+    };
+
+    adopt();
+    while (!active.empty()) {
+        unsigned int p = active.front();
+        if (tree[p] == FREE) {
+            active.pop_front();
+            continue;
+        }
+
+        // Growth: look for an edge joining both trees
+        Edge *meeting = nullptr;
+        const std::vector<Edge *> &edges = tree[p] == SOURCE_TREE ? vertices[p]->getAdj() : vertices[p]->getIncoming();
+        FLOW_STATS_ADD(verticesVisited, 1);
+        FLOW_STATS_ADD(edgesScanned, edges.size());
+        for (Edge *e: edges) {
+            if (!usable(e)) continue;
+            unsigned int q = tree[p] == SOURCE_TREE ? e->getDest()->getIndex() : e->getOrig()->getIndex();
+            if (tree[q] == FREE) {
+                tree[q] = tree[p];
+                parent[q] = e;
+                stamp[q] = stamp[p];
+                distance[q] = distance[p] + 1;
+                active.push_back(q);
+            } else if (tree[q] != tree[p]) {
+                meeting = e;
+                break;
+            }
+        }
+        if (meeting == nullptr) {
+            active.pop_front();
+            continue;
+        }
+
+        // Augmentation: the path is written in the vertices' path attributes, from a source to a sink
+        FLOW_STATS_TIMER(augmentNs);
+        FLOW_STATS_ADD(augmentingPaths, 1);
+        unsigned int sourceSide = meeting->getOrig()->getIndex();
+        unsigned int targetSide = meeting->getDest()->getIndex();
+        unsigned int origin = sourceSide;
+        for (; ; origin = parentOf(origin)) {
+            vertices[origin]->setPath(parent[origin]);
+            if (parent[origin] == nullptr) break;
+        }
+        vertices[targetSide]->setPath(meeting);
+        unsigned int sink = targetSide;
+        for (; parent[sink] != nullptr; sink = parentOf(sink)) vertices[parentOf(sink)]->setPath(parent[sink]);
+
+        flow += residualGraph.augmentTerminalPath(sink, terminals);
+
+        // Saturated tree edges leave orphans behind
+        time++;
+        for (unsigned int v = sourceSide; parent[v] != nullptr;) {
+            unsigned int next = parentOf(v);
+            if (parent[v]->getCapacity() == 0) {
+                parent[v] = nullptr;
+                orphans.push_back(v);
+            }
+            v = next;
+        }
+        for (unsigned int v = targetSide; parent[v] != nullptr;) {
+            unsigned int next = parentOf(v);
+            if (parent[v]->getCapacity() == 0) {
+                parent[v] = nullptr;
+                orphans.push_back(v);
+            }
+            v = next;
+        }
+        // Roots without supply or demand left can't start or end paths anymore
+        if (terminals.getSupply(origin) == 0) {
+            root[origin] = false;
+            orphans.push_back(origin);
+        }
+        if (terminals.getDemand(sink) == 0) {
+            root[sink] = false;
+            orphans.push_back(sink);
+        }
+        adopt();
+    }
+    return flow;
+}
+
+/**
+ * Restores flow conservation after the flow of some edges was removed, leaving vertices with more flow arriving than
+ * leaving (positive imbalance) or the opposite (negative imbalance). Each excess is sent through the residual network to
+ * the nearest vertex missing flow or terminal (source or target), and the flow still missing is then brought from the
+ * terminals. Such paths always exist, as the removed flow used to reach those vertices. Indicated for use on residual
+ * graphs
+ * Time Complexity: O(a(|V|+|E|)), a being the number of augmentations done
+ * @param imbalance - Flow arriving minus flow leaving each Vertex (ignored for terminals); left with zeros elsewhere
+ * @param terminal - Whether each Vertex is a source or the target (and thus doesn't need flow conservation)
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ */
+void Graph::restoreConservation(std::vector<long long> &imbalance, const std::vector<bool> &terminal,
+                                const std::vector<unsigned int> &source, unsigned int target) const {
+    std::vector<bool> absorbs = terminal;
+    for (unsigned int v = 0; v < imbalance.size(); v++)
+        if (imbalance[v] < 0 && !terminal[v]) absorbs[v] = true;
+
+    unsigned int reached;
+    for (unsigned int v = 0; v < imbalance.size(); v++) {
+        while (!terminal[v] && imbalance[v] > 0 && pathToAny(v, absorbs, reached)) {
+            long long amount = std::min<long long>(imbalance[v], findBottleneck(reached));
+            if (!terminal[reached]) amount = std::min(amount, -imbalance[reached]);
+            augmentPath(reached, (Capacity) amount);
+            imbalance[v] -= amount;
+            if (!terminal[reached]) {
+                imbalance[reached] += amount;
+                if (imbalance[reached] == 0) absorbs[reached] = false;
+            }
+        }
+    }
+
+    std::vector<unsigned int> terminals = source;
+    terminals.push_back(target);
+    for (unsigned int v = 0; v < imbalance.size(); v++) {
+        while (!terminal[v] && imbalance[v] < 0 && path(terminals, v)) {
+            long long amount = std::min<long long>(-imbalance[v], findBottleneck(v));
+            augmentPath(v, (Capacity) amount);
+            imbalance[v] += amount;
+        }
+    }
+}
+
+/**
+ * BFS variation of path that starts at a single vertex and stops at the first vertex of a set. Indicated for use on
+ * residual graphs
+ * Time Complexity: O(|V| + |E|)
+ * @param source - Index of the Vertex where the search starts
+ * @param terminal - Whether each Vertex ends the search
+ * @param reached - Set to the index of the Vertex the path ends at
+ * @return True if a path was found, false if not
+ */
+bool Graph::pathToAny(unsigned int source, const std::vector<bool> &terminal, unsigned int &reached) const {
+    FLOW_STATS_TIMER(pathSearchNs);
+    FLOW_STATS_ADD(pathSearches, 1);
+
+    for (Vertex *v: vertexSet) {
+        v->setVisited(false);
+        v->setPath(nullptr);
+    }
+
+    std::queue<Vertex *> q;
+    q.push(vertexSet[source]);
+    vertexSet[source]->setVisited(true);
+    while (!q.empty()) {
+        Vertex const *currentVertex = q.front();
+        q.pop();
+        FLOW_STATS_ADD(verticesVisited, 1);
+        FLOW_STATS_ADD(edgesScanned, currentVertex->getAdj().size());
+        for (Edge *e: currentVertex->getAdj()) {
+            if (!e->getDest()->isVisited() && e->getCapacity() > 0 && isRailActive(e->getIndex())) {
+                q.push(e->getDest());
+                e->getDest()->setVisited(true);
+                e->getDest()->setPath(e);
+                if (terminal[e->getDest()->getIndex()]) {
+                    reached = e->getDest()->getIndex();
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * BFS variation of path that starts at every source with at least minCapacity supply left and stops at the first vertex
+ * with at least minCapacity demand left, as if searching from a super source to a super sink. Indicated for use on
+ * residual graphs
+ * Time Complexity: O(|V| + |E|)
+ * @param terminals - Virtual arcs of the sources and sinks
+ * @param minCapacity - Minimum available capacity of the edges and virtual arcs of the path
+ * @param reached - Set to the index of the sink reached, if any
+ * @return True if a path was found, false if not
+ */
+bool Graph::terminalPath(const TerminalArcs &terminals, Capacity minCapacity, unsigned int &reached) const {
+    FLOW_STATS_TIMER(pathSearchNs);
+    FLOW_STATS_ADD(pathSearches, 1);
+
+    std::queue<Vertex *> q;
+    for (Vertex *v: vertexSet) {
+        v->setPath(nullptr);
+        v->setVisited(terminals.getSupply(v->getIndex()) >= minCapacity);
+        if (v->isVisited()) q.push(v);
+    }
+
+    while (!q.empty()) {
+        Vertex const *currentVertex = q.front();
+        q.pop();
+        if (terminals.getDemand(currentVertex->getIndex()) >= minCapacity) {
+            reached = currentVertex->getIndex();
+            return true;
+        }
+        FLOW_STATS_ADD(verticesVisited, 1);
+        FLOW_STATS_ADD(edgesScanned, currentVertex->getAdj().size());
+        for (Edge *e: currentVertex->getAdj()) {
+            if (!e->getDest()->isVisited() && e->getCapacity() >= minCapacity && isRailActive(e->getIndex())) {
+                q.push(e->getDest());
+                e->getDest()->setVisited(true);
+                e->getDest()->setPath(e);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Adapted BFS that checks if there is a valid path connecting the source and target vertices. Indicated for use on residual graphs
+ * Time Complexity: O(|V| + |E|)
+ * @param source - List of ids of the source Vertex(es)
+ * @param target - Id of the target Vertex
+ * @return True if a path was found, false if not
+ */
+bool Graph::path(const std::list<std::string> &source, const std::string &target) const {
+    std::vector<unsigned int> sourceIndexes;
+    for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+    return path(sourceIndexes, findVertex(target)->getIndex());
+}
+
+/**
+ * Adapted BFS that checks if there is a valid path connecting the source and target vertices, given by their index. The
+ * search starts from every source at once, as if from a virtual super source. Indicated for use on residual graphs
+ * Time Complexity: O(|V| + |E|)
+ * @param source - Indexes of the source Vertex(es); the target is skipped if it is one of them
+ * @param target - Index of the target Vertex
+ * @param minCapacity - Smallest capacity of the edges the path may use
+ * @return True if a path was found, false if not
+ */
+bool Graph::path(const std::vector<unsigned int> &source, unsigned int target, Capacity minCapacity) const {
+    FLOW_STATS_TIMER(pathSearchNs);
+    FLOW_STATS_ADD(pathSearches, 1);
+
+    for (Vertex *v: vertexSet) {
+        v->setVisited(false);
+        v->setPath(nullptr);
+    }
+
+    Vertex const *targetVertex = vertexSet[target];
+    std::queue<Vertex *> q;
+    for (unsigned int s: source) {
+        if (s == target) continue;
+        q.push(vertexSet[s]);
+        vertexSet[s]->setVisited(true);
+    }
+
+    while (!q.empty()) {
+        Vertex const *currentVertex = q.front();
+        q.pop();
+        FLOW_STATS_ADD(verticesVisited, 1);
+        FLOW_STATS_ADD(edgesScanned, currentVertex->getAdj().size());
+        for (Edge *e: currentVertex->getAdj()) {
+            if (!e->getDest()->isVisited() && e->getCapacity() >= minCapacity && isRailActive(e->getIndex())) {
+                q.push(e->getDest());
+                e->getDest()->setVisited(true);
+                e->getDest()->setPath(e);
+                if (e->getDest() == targetVertex) return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds an augmenting path with the chosen search strategy, leaving it in the path attribute of the vertices (so that
+ * findBottleneck and augmentPath can follow it back from the target). Indicated for use on residual graphs
+ * Time Complexity: O(|V| + |E|)
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param minCapacity - Smallest capacity of the edges the path may use
+ * @param search - Search strategy
+ * @return True if a path was found, false if not
+ */
+bool Graph::augmentingPath(const std::vector<unsigned int> &source, unsigned int target, Capacity minCapacity,
+                           PathSearch search) const {
+    if (search == PathSearch::BIDIRECTIONAL) return bidirectionalPath(source, target, minCapacity);
+    return path(source, target, minCapacity);
+}
+
+/**
+ * Bidirectional BFS variation of path: a forward search from the sources and a backward search from the target (over
+ * the incoming edges) are expanded one level at a time, always the one with the smaller frontier, until they meet.
+ * On long lines, each side only explores about half the distance, so far fewer vertices are visited. Indicated for
+ * use on residual graphs
  * Time Complexity: O(|V| + |E|)
- * @param source - List of ids of the source Vertex(es)
- * @param target - Id of the target Vertex
+ * @param source - Indexes of the source Vertex(es); the target is skipped if it is one of them
+ * @param target - Index of the target Vertex
+ * @param minCapacity - Smallest capacity of the edges the path may use
  * @return True if a path was found, false if not
  */
-bool Graph::path(const std::list<std::string> &source, const std::string &target) const {
+bool Graph::bidirectionalPath(const std::vector<unsigned int> &source, unsigned int target,
+                              Capacity minCapacity) const {
+    FLOW_STATS_TIMER(pathSearchNs);
+    FLOW_STATS_ADD(pathSearches, 1);
 
     for (Vertex *v: vertexSet) {
         v->setVisited(false);
         v->setPath(nullptr);
     }
-
-    std::queue<std::string> q;
-    for (const auto &it: source) {
-        q.push(it);
-        findVertex(it)->setVisited(true);
+    std::vector<bool> reachesTarget(vertexSet.size(), false); // visited by the backward search
+    std::vector<Edge *> towardsTarget(vertexSet.size(), nullptr); // next edge of the backward search tree
+
+    std::vector<Vertex *> forward, backward, next;
+    for (unsigned int s: source) {
+        if (s == target || vertexSet[s]->isVisited()) continue;
+        vertexSet[s]->setVisited(true);
+        forward.push_back(vertexSet[s]);
     }
-
-    while (!q.empty()) {
-        Vertex const *currentVertex = findVertex(q.front());
-        q.pop();
-        for (Edge *e: currentVertex->getAdj()) {
-            if (!e->getDest()->isVisited() && e->getCapacity() > 0 && e->isSelected()) {
-                q.push(e->getDest()->getId());
-                e->getDest()->setVisited(true);
-                e->getDest()->setPath(e);
-                if (e->getDest()->getId() == target) return true;
+    reachesTarget[target] = true;
+    backward.push_back(vertexSet[target]);
+
+    // Completes the path attributes from the edge where both searches met up to the target
+    auto linkThrough = [&](Edge *bridge) {
+        for (Edge *e = bridge; e != nullptr; e = towardsTarget[e->getDest()->getIndex()])
+            e->getDest()->setPath(e);
+    };
+
+    while (!forward.empty() && !backward.empty()) {
+        next.clear();
+        if (forward.size() <= backward.size()) {
+            for (Vertex const *v: forward) {
+                FLOW_STATS_ADD(verticesVisited, 1);
+                FLOW_STATS_ADD(edgesScanned, v->getAdj().size());
+                for (Edge *e: v->getAdj()) {
+                    Vertex *dest = e->getDest();
+                    if (dest->isVisited() || e->getCapacity() < minCapacity || !isRailActive(e->getIndex())) continue;
+                    if (reachesTarget[dest->getIndex()]) {
+                        linkThrough(e);
+                        return true;
+                    }
+                    dest->setVisited(true);
+                    dest->setPath(e);
+                    next.push_back(dest);
+                }
+            }
+            forward.swap(next);
+        } else {
+            for (Vertex const *v: backward) {
+                FLOW_STATS_ADD(verticesVisited, 1);
+                FLOW_STATS_ADD(edgesScanned, v->getIncoming().size());
+                for (Edge *e: v->getIncoming()) {
+                    Vertex *orig = e->getOrig();
+                    if (reachesTarget[orig->getIndex()] || e->getCapacity() < minCapacity ||
+                        !isRailActive(e->getIndex()))
+                        continue;
+                    if (orig->isVisited()) {
+                        linkThrough(e);
+                        return true;
+                    }
+                    reachesTarget[orig->getIndex()] = true;
+                    towardsTarget[orig->getIndex()] = e;
+                    next.push_back(orig);
+                }
             }
+            backward.swap(next);
         }
     }
     return false;
 }
 
 /**
- * Bellman-Ford algorithm variation that returns a list of edges belonging to a negative cycle that was found
+ * Bellman-Ford algorithm variation that returns a list of edges belonging to a negative cycle that was found. Every
+ * Vertex starts at distance 0, as if reached from a virtual vertex, so that negative cycles not reachable from the
+ * source are found as well
  * Time Complexity: O(|VE|)
  * @param source - Id of source Vertex, to which distances will be relative to
  * @return List of pointers to Edges that belong to a negative cycle, or an empty list if no negative cycle was found
  */
 std::list<Edge *> Graph::bellmanFord(const std::string &source) {
+    FLOW_STATS_ADD(bellmanFordPasses, 1);
     for (Vertex *v: vertexSet) {
-        v->setCost(UINT32_MAX);
+        v->setCost(0);
         v->setPath(nullptr);
     }
     findVertex(source)->setCost(0);
@@ -157,7 +1160,7 @@ std::list<Edge *> Graph::bellmanFord(const std::string &source) {
         for (Vertex *v: vertexSet) { //Relax every Edge
             for (Edge *e: v->getIncoming()) {
                 if (e->getCapacity() > 0) {
-                    int tempCost = e->getOrig()->getCost() + e->getCost();
+                    Cost tempCost = e->getOrig()->getCost() + e->getCost();
                     if (tempCost < v->getCost()) {
                         if (i == vertexSet.size()) { //Edge being relaxed on Nth iteration - Negative cycle!
                             Vertex *currentVertex = v;
@@ -168,10 +1171,12 @@ std::list<Edge *> Graph::bellmanFord(const std::string &source) {
                                 currentVertex = currentVertex->getPath()->getOrig();
                             }
 
-                            for (Vertex *temp = currentVertex;; temp = temp->getPath()->getOrig()) {
-                                negativeCycle.push_back(currentVertex->getPath());
-                                if (temp == currentVertex && negativeCycle.size() > 1) return negativeCycle;
-                            }
+                            Vertex *temp = currentVertex;
+                            do {
+                                negativeCycle.push_back(temp->getPath());
+                                temp = temp->getPath()->getOrig();
+                            } while (temp != currentVertex);
+                            return negativeCycle;
                         }
                         v->setCost(tempCost);
                         v->setPath(e);
@@ -188,27 +1193,34 @@ std::list<Edge *> Graph::bellmanFord(const std::string &source) {
  * @param source - Id of the source Vertex
  * @param target - Id of the target Vertex
  * @param residualGraph - Graph object representing this Graph's residual network
- * @return A pair of unsigned ints representing the value of the max flow and its min cost
+ * @return A pair representing the value of the max flow and its min cost
  */
-std::pair<unsigned int, unsigned int>
+std::pair<Capacity, Cost>
 Graph::minCostMaxFlow(const std::string &source, const std::string &target, Graph &residualGraph) {
-    std::pair<unsigned int, unsigned int> result;
+    std::pair<Capacity, Cost> result;
     result.first = edmondsKarp({source}, target, residualGraph);
 
     Graph minCostResidual;
-    makeMinCostResidual(minCostResidual);
+    {
+        FLOW_STATS_TIMER(residualBuildNs);
+        makeMinCostResidual(minCostResidual);
+    }
 
-    std::list<Edge *> negativeCycle = minCostResidual.bellmanFord(source);
-    while (!negativeCycle.empty()) {
-        unsigned int bottleneckCapacity = findListBottleneck(negativeCycle);
-        augmentMinCostPath(negativeCycle, bottleneckCapacity);
-        negativeCycle = minCostResidual.bellmanFord(source);
+    {
+        FLOW_STATS_TIMER(cycleCancellingNs);
+        std::list<Edge *> negativeCycle = minCostResidual.bellmanFord(source);
+        while (!negativeCycle.empty()) {
+            FLOW_STATS_ADD(negativeCycles, 1);
+            Capacity bottleneckCapacity = findListBottleneck(negativeCycle);
+            augmentMinCostPath(negativeCycle, bottleneckCapacity);
+            negativeCycle = minCostResidual.bellmanFord(source);
+        }
     }
 
-    unsigned int cost = 0;
+    Cost cost = 0;
     for (Vertex *v: vertexSet) {
         for (Edge *e: v->getAdj()) {
-            cost += e->getCost() * e->getFlow();
+            cost += e->getCost() * (Cost) e->getFlow();
         }
     }
     result.second = cost;
@@ -222,10 +1234,20 @@ Graph::minCostMaxFlow(const std::string &source, const std::string &target, Grap
  * @param target - Id of the target Vertex
  * @return Bottleneck (minimum) capacity of the path connecting source to target
  */
-unsigned int Graph::findBottleneck(const std::string &target) const {
-    Vertex const *currentVertex = findVertex(target);
-    unsigned int currBottleneck;
-    unsigned int bottleneck = UINT32_MAX;
+Capacity Graph::findBottleneck(const std::string &target) const {
+    return findBottleneck(findVertex(target)->getIndex());
+}
+
+/**
+ * Finds the minimum available capacity value in the path connecting source and target vertices
+ * Time Complexity: O(|E|)
+ * @param target - Index of the target Vertex
+ * @return Bottleneck (minimum) capacity of the path connecting source to target
+ */
+Capacity Graph::findBottleneck(unsigned int target) const {
+    Vertex const *currentVertex = vertexSet[target];
+    Capacity currBottleneck;
+    Capacity bottleneck = INFINITE_CAPACITY;
 
     while (currentVertex->getPath() != nullptr) {
 
@@ -245,9 +1267,9 @@ unsigned int Graph::findBottleneck(const std::string &target) const {
  * @param edges - List of pointers to the Edges to evaluate
  * @return Bottleneck (minimum) capacity of the list of Edges
  */
-unsigned int Graph::findListBottleneck(const std::list<Edge *> &edges) {
-    unsigned int currBottleneck;
-    unsigned int bottleneck = UINT32_MAX;
+Capacity Graph::findListBottleneck(const std::list<Edge *> &edges) {
+    Capacity currBottleneck;
+    Capacity bottleneck = INFINITE_CAPACITY;
 
     for (Edge *e: edges) {
         currBottleneck = e->getCapacity();
@@ -264,8 +1286,18 @@ unsigned int Graph::findListBottleneck(const std::list<Edge *> &edges) {
  * @param target - Id of the target Vertex
  * @param value - Number of units to alter the flow by
  */
-void Graph::augmentPath(const std::string &target, const unsigned int &value) const {
-    Vertex const *currentVertex = findVertex(target);
+void Graph::augmentPath(const std::string &target, const Capacity &value) const {
+    augmentPath(findVertex(target)->getIndex(), value);
+}
+
+/**
+ * Augments or reduces the flow in the regular Graph path connecting source to target by value units, and updates the residual network. Indicated for use on residual graphs
+ * Time Complexity: O(|E|)
+ * @param target - Index of the target Vertex
+ * @param value - Number of units to alter the flow by
+ */
+void Graph::augmentPath(unsigned int target, const Capacity &value) const {
+    Vertex const *currentVertex = vertexSet[target];
 
     while (currentVertex->getPath() != nullptr) {
         Edge *residualEdge = currentVertex->getPath();
@@ -273,31 +1305,36 @@ void Graph::augmentPath(const std::string &target, const unsigned int &value) co
         Edge *regularEdge = residualEdge->getCorrespondingEdge();
         Edge *reverseRegularEdge = regularEdge->getReverse();
 
+        //Cancel the flow going the opposite way first, and only then push the rest forward
+        Capacity cancelled = std::min(value, reverseRegularEdge->getFlow());
+        reverseRegularEdge->setFlow(reverseRegularEdge->getFlow() - cancelled);
+        regularEdge->setFlow(regularEdge->getFlow() + value - cancelled);
 
-        if (regularEdge->getFlow() + value > regularEdge->getCapacity()) { //Intended value exceeds capacity
-
-            //Augment flow in regular graph
-            unsigned int intendedValue = regularEdge->getFlow() + value;
-            regularEdge->setFlow(regularEdge->getCapacity());
-            reverseRegularEdge->setFlow(reverseRegularEdge->getFlow() - (intendedValue -
-                                                                         regularEdge->getCapacity())); //Reduce reverse edge flow by exceeding amount
-            //Update residual Graph edges
-            residualEdge->setCapacity(0);
-            reverseResidualEdge->setCapacity(reverseResidualEdge->getCapacity() + (intendedValue -
-                                                                                   regularEdge->getCapacity()));
-
-        } else { //Intended value is within capacity
+        //Update residual Graph edges
+        residualEdge->setCapacity(regularEdge->getCapacity() - regularEdge->getFlow() + reverseRegularEdge->getFlow());
+        reverseResidualEdge->setCapacity(
+                reverseRegularEdge->getCapacity() - reverseRegularEdge->getFlow() + regularEdge->getFlow());
 
-            //Augment flow in regular graph
-            regularEdge->setFlow(regularEdge->getFlow() + value);
+        currentVertex = residualEdge->getOrig();
+    }
+}
 
-            //Update residual Graph edges
-            residualEdge->setCapacity(regularEdge->getCapacity() - regularEdge->getFlow());
-            reverseResidualEdge->setCapacity(reverseResidualEdge->getCapacity() + value);
+/**
+ * Augments the flow in the regular Graph path connecting a source to a sink by as much as its edges, the supply left at
+ * the source and the demand left at the sink allow, and updates the residual network and the virtual arcs. Indicated
+ * for use on residual graphs
+ * Time Complexity: O(|E|)
+ * @param sink - Index of the Vertex the path ends at
+ * @param terminals - Virtual arcs of the sources and sinks
+ * @return Flow sent through the path
+ */
+Capacity Graph::augmentTerminalPath(unsigned int sink, TerminalArcs &terminals) const {
+    Vertex const *origin = vertexSet[sink];
+    while (origin->getPath() != nullptr) origin = origin->getPath()->getOrig();
 
-        }
-        currentVertex = currentVertex->getPath()->getOrig();
-    }
+    Capacity flow = terminals.use(origin->getIndex(), sink, findBottleneck(sink));
+    augmentPath(sink, flow);
+    return flow;
 }
 
 /**
@@ -306,7 +1343,7 @@ void Graph::augmentPath(const std::string &target, const unsigned int &value) co
  * @param edges - List of pointers to the Edges whose flow will be altered
  * @param value - Number of units to alter the flow by
  */
-void Graph::augmentMinCostPath(const std::list<Edge *> &edges, const unsigned int &value) {
+void Graph::augmentMinCostPath(const std::list<Edge *> &edges, const Capacity &value) {
 
     for (Edge *residualEdge: edges) {
         Edge *reverseResidualEdge = residualEdge->getReverse(); //For each minCostResidual edge, its reverse is the corresponding negative cost edge, and vice-versa
@@ -350,7 +1387,7 @@ std::vector<Edge *> Graph::randomlySelectEdges(unsigned int numEdges) {
         if (currentVertex->getAdj().empty()) continue;
         choice = rand() % currentVertex->getAdj().size();
 
-        if (currentVertex->getAdj()[choice]->isSelected()) {
+        if (isRailActive(currentVertex->getAdj()[choice]->getIndex())) {
             deactivatedEdges.push_back(currentVertex->getAdj()[choice]);
         }
     }
@@ -358,31 +1395,134 @@ std::vector<Edge *> Graph::randomlySelectEdges(unsigned int numEdges) {
 }
 
 /**
- * Takes a vector of edge pointers and sets the selected state of those edges, their reverses and their corresponding edges in the residual graph to false
+ * Takes a vector of edge pointers and clears the activation bits of their rails, which also deactivates their reverses
+ * and their corresponding edges in the residual graph
  * Time Complexity: O(size(edges))
  * @param edges - Vector of edge pointers to be deactivated
  */
 void Graph::deactivateEdges(const std::vector<Edge *> &edges) {
-    for (Edge *edge: edges) {
-        edge->setSelected(false);
-        edge->getCorrespondingEdge()->setSelected(false);
-        edge->getReverse()->setSelected(false);
-        edge->getReverse()->getCorrespondingEdge()->setSelected(false);
+    std::vector<unsigned long long> &active = *activeRails;
+    for (Edge const *edge: edges) {
+        unsigned int rail = edge->getIndex();
+        if (isRailActive(rail)) deactivatedHash ^= railHash(rail);
+        active[rail / 64] &= ~(1ULL << (rail % 64));
     }
 }
 
 /**
- * Takes a vector of edge pointers and sets the selected state of those edges, their reverses and their corresponding edges in the residual graph to true
+ * Takes a vector of edge pointers and sets the activation bits of their rails, which also activates their reverses and
+ * their corresponding edges in the residual graph
  * Time Complexity: O(size(edges))
  * @param edges - Vector of edge pointers to be activated
  */
 void Graph::activateEdges(const std::vector<Edge *> &edges) {
-    for (Edge *edge: edges) {
-        edge->setSelected(true);
-        edge->getCorrespondingEdge()->setSelected(true);
-        edge->getReverse()->setSelected(true);
-        edge->getReverse()->getCorrespondingEdge()->setSelected(true);
+    std::vector<unsigned long long> &active = *activeRails;
+    for (Edge const *edge: edges) {
+        unsigned int rail = edge->getIndex();
+        if (!isRailActive(rail)) deactivatedHash ^= railHash(rail);
+        active[rail / 64] |= 1ULL << (rail % 64);
+    }
+}
+
+/**
+ * Deactivates every rail of a bitset, 64 rails at a time
+ * Time Complexity: O(|E|/64 + 64w), w being the number of 64-rail words with rails that were active
+ * @param mask - Bitset with one bit per rail, set for the rails to deactivate (it may be shorter than the rail count)
+ * @return Bitset of the rails that were active and were deactivated, to be given to activateRails to undo the change
+ */
+std::vector<unsigned long long> Graph::deactivateRails(const std::vector<unsigned long long> &mask) {
+    std::vector<unsigned long long> &active = *activeRails;
+    std::vector<unsigned long long> changed(std::min(mask.size(), active.size()), 0);
+    for (unsigned int word = 0; word < changed.size(); word++) {
+        changed[word] = active[word] & mask[word];
+        if (changed[word] == 0) continue;
+        active[word] &= ~changed[word];
+        for (unsigned int bit = 0; bit < 64; bit++)
+            if ((changed[word] >> bit) & 1) deactivatedHash ^= railHash(word * 64 + bit);
+    }
+    return changed;
+}
+
+/**
+ * Activates every rail of a bitset, 64 rails at a time
+ * Time Complexity: O(|E|/64 + 64w), w being the number of 64-rail words with rails that were inactive
+ * @param mask - Bitset with one bit per rail, set for the rails to activate (it may be shorter than the rail count)
+ */
+void Graph::activateRails(const std::vector<unsigned long long> &mask) {
+    std::vector<unsigned long long> &active = *activeRails;
+    for (unsigned int word = 0; word < std::min(mask.size(), active.size()); word++) {
+        unsigned long long changed = ~active[word] & mask[word];
+        if (changed == 0) continue;
+        active[word] |= changed;
+        for (unsigned int bit = 0; bit < 64; bit++)
+            if ((changed >> bit) & 1) deactivatedHash ^= railHash(word * 64 + bit);
+    }
+}
+
+/**
+ * Checks whether a rail is active, in either direction and in both this Graph and its residual network
+ * Time Complexity: O(1)
+ * @param rail - Index of the rail
+ * @return True if the rail is active, false if it was deactivated
+ */
+bool Graph::isRailActive(unsigned int rail) const {
+    return ((*activeRails)[rail / 64] >> (rail % 64)) & 1;
+}
+
+const std::vector<unsigned long long> &Graph::getActiveRails() const {
+    return *activeRails;
+}
+
+/**
+ * Makes a Graph (normally, this Graph's residual network, which has the same rail indexes) use this Graph's rail
+ * activation bitset, so that deactivating a rail here also deactivates it there
+ * Time Complexity: O(1)
+ * @param residualGraph - Graph object representing this Graph's residual network
+ */
+void Graph::shareRailActivation(Graph &residualGraph) const {
+    residualGraph.activeRails = activeRails;
+}
+
+Edge *Graph::getRail(unsigned int index) const {
+    return edgeSet[index];
+}
+
+/**
+ * Changes the capacity of some rails, in both directions. As the current flow may no longer fit, flows are reset
+ * Time Complexity: O(|E|)
+ * @param capacities - Rails (either direction) and their new capacity
+ */
+void Graph::setRailCapacities(const std::vector<std::pair<Edge *, Capacity>> &capacities) {
+    for (const auto &[rail, capacity]: capacities) {
+        rail->setCapacity(capacity);
+        rail->getReverse()->setCapacity(capacity);
     }
+    topologyVersion++;
+    resetFlows();
+}
+
+/**
+ * Computes the max flow between the source(s) and the target in several what-if scenarios. The scenarios are split
+ * among worker threads, each applying them in turn to its own copy of the network, so this Graph is left untouched and
+ * no scenario is copied. Each max flow is repaired from the previous one of the same worker (see warmMaxFlow), unless
+ * the scenario changes capacities
+ * Time Complexity: O(s|VE²|) (divided among the workers), plus O(w(|V|+|E|)) for copying the network, s being the
+ * number of scenarios and w the number of workers
+ * @param scenarios - Scenarios over this Graph's rails
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param numWorkers - Number of worker threads
+ * @return The max flow in each scenario, in the same order as scenarios
+ */
+std::vector<Capacity> Graph::scenarioMaxFlows(const std::vector<Scenario> &scenarios,
+                                              const std::vector<unsigned int> &source, unsigned int target,
+                                              unsigned int numWorkers) const {
+    std::vector<Capacity> flows(scenarios.size());
+    forEachOnCopies((unsigned int) scenarios.size(), numWorkers, [&](unsigned int i, Graph &graph, Graph &residual) {
+        AppliedScenario scenario(graph, scenarios[i]);
+        flows[i] = graph.warmMaxFlow(source, target, residual);
+    });
+    return flows;
 }
 
 /**
@@ -392,21 +1532,172 @@ void Graph::activateEdges(const std::vector<Edge *> &edges) {
  * @param source - List of Ids of source vertexes
  * @param target - Id of the target Vertex
  * @param residualGraph - Graph object representing this Graph's residual network
+ * @param engine - Max flow algorithm to use
+ * @param search - Strategy used to find the augmenting paths
  * @return A pair with the max flow before deactivating the Edges and after
  */
-std::pair<unsigned int, unsigned int>
+std::pair<Capacity, Capacity>
 Graph::maxFlowDeactivatedEdges(const std::vector<Edge *> &selectedEdges, const std::list<std::string> &source,
-                               const std::string &target, Graph &residualGraph) {
+                               const std::string &target, Graph &residualGraph, MaxFlowEngine engine,
+                               PathSearch search) {
+
+    std::pair<Capacity, Capacity> result;
+    if (engine == MaxFlowEngine::EDMONDS_KARP) {
+        // The reduced flow is found by repairing the original one
+        std::vector<unsigned int> sourceIndexes;
+        for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+        unsigned int targetIndex = findVertex(target)->getIndex();
+        result.first = warmMaxFlow(sourceIndexes, targetIndex, residualGraph, search);
+        AppliedScenario failure(*this, selectedEdges);
+        result.second = warmMaxFlow(sourceIndexes, targetIndex, residualGraph, search);
+        return result;
+    }
+    if (engine == MaxFlowEngine::BOYKOV_KOLMOGOROV) {
+        // The reduced flow is found by repairing the original flow and search trees
+        std::vector<unsigned int> sourceIndexes;
+        for (const std::string &s: source) sourceIndexes.push_back(findVertex(s)->getIndex());
+        unsigned int targetIndex = findVertex(target)->getIndex();
+        result.first = boykovKolmogorov(sourceIndexes, targetIndex, residualGraph, true);
+        AppliedScenario failure(*this, selectedEdges);
+        result.second = boykovKolmogorov(sourceIndexes, targetIndex, residualGraph, true);
+        return result;
+    }
 
-    std::pair<unsigned int, unsigned int> result;
-    result.first = edmondsKarp(source, target, residualGraph);
-    deactivateEdges(selectedEdges);
-    result.second = edmondsKarp(source, target, residualGraph);
-    activateEdges(selectedEdges);
+    result.first = maxFlow(source, target, residualGraph, engine, search);
+    AppliedScenario failure(*this, selectedEdges);
+    result.second = maxFlow(source, target, residualGraph, engine, search);
 
     return result;
 }
 
+/**
+ * Lists the active rails carrying flow (in either direction) in the current flow
+ * Time Complexity: O(|E|)
+ * @return Indexes of the rails
+ */
+std::vector<unsigned int> Graph::loadedRails() const {
+    std::vector<unsigned int> loaded;
+    for (Edge const *rail: edgeSet)
+        if (isRailActive(rail->getIndex()) && (rail->getFlow() > 0 || rail->getReverse()->getFlow() > 0))
+            loaded.push_back(rail->getIndex());
+    return loaded;
+}
+
+/**
+ * Orders failure scenarios from worst to best: by smallest remaining flow, then by fewest failed rails, then by the
+ * (sorted) indexes of the failed rails, so that the reported worst scenario doesn't depend on the search order
+ */
+bool worseFailure(Capacity flow, const std::vector<unsigned int> &rails,
+                  const std::pair<std::vector<unsigned int>, Capacity> &other) {
+    if (flow != other.second) return flow < other.second;
+    if (rails.size() != other.first.size()) return rails.size() < other.first.size();
+    return rails < other.first;
+}
+
+/**
+ * Computes the max flow with one more rail failed on top of the chosen ones, and recursively extends that failure set
+ * with the rails carrying flow in the resulting max flow, up to k rails. Rails that carry no flow can be skipped: the
+ * max flow stays feasible without them, so failing them can't reduce it. Each max flow is repaired from the previous
+ * one (see warmMaxFlow), so failure sets sharing a prefix share most of the work. A rail already explored by an
+ * earlier sibling is excluded from the later siblings' subtrees, as every failure set containing it was covered there
+ * Time Complexity: O(c^k) max flow repairs, c being the number of rails carrying flow
+ * @param sortedSource - Indexes of the source Vertex(es), sorted and without the target
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param k - Maximum number of failed rails
+ * @param rail - Index of the rail to fail
+ * @param chosen - Indexes of the rails already failed
+ * @param excluded - Whether each rail is excluded from this subtree
+ * @param worst - Worst failure set found so far (sorted rail indexes and flow) with at most 1, 2, ..., k rails
+ * @param evaluated - Number of failure sets evaluated, to be updated
+ */
+void Graph::searchFailures(const std::vector<unsigned int> &sortedSource, unsigned int target, Graph &residualGraph,
+                           unsigned int k, unsigned int rail, std::vector<unsigned int> &chosen,
+                           std::vector<bool> &excluded,
+                           std::vector<std::pair<std::vector<unsigned int>, Capacity>> &worst,
+                           unsigned long long &evaluated) {
+    AppliedScenario failure(*this, {edgeSet[rail]});
+    chosen.push_back(rail);
+    Capacity flow = warmMaxFlow(sortedSource, target, residualGraph);
+    evaluated++;
+
+    std::vector<unsigned int> rails = chosen;
+    std::sort(rails.begin(), rails.end());
+    for (size_t size = chosen.size(); size <= k; size++)
+        if (worseFailure(flow, rails, worst[size - 1])) worst[size - 1] = {rails, flow};
+
+    // Once a failure set of this size leaves no flow, larger ones can't be worse
+    if (chosen.size() < k && worst[chosen.size() - 1].second > 0) {
+        std::vector<unsigned int> next;
+        for (unsigned int r: loadedRails()) if (!excluded[r]) next.push_back(r);
+        for (unsigned int r: next) {
+            searchFailures(sortedSource, target, residualGraph, k, r, chosen, excluded, worst, evaluated);
+            excluded[r] = true;
+        }
+        for (unsigned int r: next) excluded[r] = false;
+    }
+
+    chosen.pop_back();
+}
+
+/**
+ * N-k contingency analysis: finds, for every size up to k, the set of rails whose failure reduces the max flow between
+ * the source(s) and the target the most. Only failure sets where every rail carries flow in the max flow left by the
+ * previous failures are evaluated (see searchFailures); the other sets can't be worse than one of their subsets. The
+ * subtrees of the rails carrying flow in the original max flow are split among worker threads, each with its own copy
+ * of the network
+ * Time Complexity: O(c^k) max flow repairs (divided among the workers), c being the number of rails carrying flow
+ * @param source - Indexes of the source Vertex(es)
+ * @param target - Index of the target Vertex
+ * @param residualGraph - Graph object representing this Graph's residual network
+ * @param k - Maximum number of failed rails
+ * @param numWorkers - Number of worker threads
+ * @return The original max flow, the worst failure set with at most 1, 2, ..., k rails (empty if no failure reduces the
+ * flow) and the number of failure sets evaluated
+ */
+FailureAnalysis Graph::worstFailures(const std::vector<unsigned int> &source, unsigned int target,
+                                     Graph &residualGraph, unsigned int k, unsigned int numWorkers) {
+    using Failures = std::vector<std::pair<std::vector<unsigned int>, Capacity>>;
+    std::vector<unsigned int> sortedSource = distinctSources(source, target);
+
+    FailureAnalysis analysis;
+    resetFlows();
+    analysis.original = warmMaxFlow(sortedSource, target, residualGraph);
+    if (k == 0) return analysis;
+
+    std::vector<unsigned int> loaded = loadedRails();
+    std::vector<Failures> branchWorst(loaded.size(), Failures(k, {{}, analysis.original}));
+    std::vector<unsigned long long> branchEvaluated(loaded.size(), 0);
+    auto searchBranch = [&](unsigned int i, Graph &graph, Graph &residual) {
+        // Every branch starts from the same flow, so that the sets it evaluates don't depend on the scheduling
+        graph.resetFlows();
+        graph.warmMaxFlow(sortedSource, target, residual);
+        std::vector<bool> excluded(edgeSet.size(), false);
+        for (unsigned int j = 0; j < i; j++) excluded[loaded[j]] = true;
+        std::vector<unsigned int> chosen;
+        graph.searchFailures(sortedSource, target, residual, k, loaded[i], chosen, excluded, branchWorst[i],
+                             branchEvaluated[i]);
+    };
+
+    if (numWorkers > 1) forEachOnCopies((unsigned int) loaded.size(), numWorkers, searchBranch);
+    else for (unsigned int i = 0; i < loaded.size(); i++) searchBranch(i, *this, residualGraph);
+
+    Failures worst(k, {{}, analysis.original});
+    for (unsigned int i = 0; i < loaded.size(); i++) {
+        analysis.evaluated += branchEvaluated[i];
+        for (unsigned int size = 0; size < k; size++)
+            if (worseFailure(branchWorst[i][size].second, branchWorst[i][size].first, worst[size]))
+                worst[size] = branchWorst[i][size];
+    }
+    for (const auto &[rails, flow]: worst) {
+        FailureScenario scenario;
+        for (unsigned int rail: rails) scenario.rails.push_back(edgeSet[rail]);
+        scenario.flow = flow;
+        analysis.worst.push_back(scenario);
+    }
+    return analysis;
+}
+
 
 /**
 * Finds the stations that are at the end of the indicated station's line (i.e have only connection to one other station)
@@ -436,85 +1727,409 @@ std::list<std::string> Graph::findEndOfLines(const std::string &stationId) const
 
 
 /**
- * Creates an ordered vector with incoming fluxes of each station before and after edge deactivation
- * Time Complexity: O(|V²E²|)
+ * Percentage of a flow that is lost when it goes from base to reduced
+ * Time Complexity: O(1)
+ */
+double reductionPercentage(Capacity base, Capacity reduced) {
+    return base == 0 ? 0 : (100 - ((reduced * 1.0) / base) * 100);
+}
+
+bool sort_reduction_decreasing(const std::pair<std::string, std::pair<Capacity, Capacity>> &p1,
+                               const std::pair<std::string, std::pair<Capacity, Capacity>> &p2) {
+    double reduction1 = reductionPercentage(p1.second.first, p1.second.second);
+    double reduction2 = reductionPercentage(p2.second.first, p2.second.second);
+    if (reduction1 != reduction2) return reduction1 > reduction2;
+    return p1.first < p2.first;
+}
+
+/**
+ * Creates an ordered vector with incoming fluxes of each station before and after edge deactivation. Ties are ordered by
+ * station name, so that the result doesn't depend on the number of workers
+ * Time Complexity: O(|V²E²|) (divided among the workers)
  * @param edges - Edges to be deactivated
  * @param residualGraph - Graph object representing the graph's residual network
+ * @param numWorkers - Number of threads computing fluxes at the same time
  * @return An ordered vector of pairs, with the name of the station first, and a pair of the original max flow and the reduced max flow
  */
-std::vector<std::pair<std::string, std::pair<unsigned int, unsigned int>>>
-Graph::topReductions(const std::vector<Edge *> &edges, Graph &residualGraph) {
-    std::vector<std::pair<std::string, std::pair<unsigned int, unsigned int>>> result;
+std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>>
+Graph::topReductions(const std::vector<Edge *> &edges, Graph &residualGraph, unsigned int numWorkers) {
+    std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>> result;
 
-    for (Vertex *v: vertexSet) {
-        unsigned int baseFlow = incomingFlux(v->getId(), residualGraph);
-        unsigned int reducedFlow = incomingReducedFlux(edges, v->getId(), residualGraph);
-        result.push_back({v->getId(), {baseFlow, reducedFlow}});
+    std::vector<unsigned int> stations(vertexSet.size());
+    for (unsigned int i = 0; i < stations.size(); i++) stations[i] = i;
+    std::unique_ptr<CopyWorkspace> workers = numWorkers > 1 ? std::make_unique<CopyWorkspace>(numWorkers) : nullptr;
+    std::vector<std::pair<Capacity, Capacity>> fluxes = incomingFluxReductions(stations, edges, residualGraph,
+                                                                                       workers.get());
+    for (unsigned int i = 0; i < stations.size(); i++) result.push_back({vertexSet[i]->getId(), fluxes[i]});
+
+    std::sort(result.begin(), result.end(), sort_reduction_decreasing);
+
+    return result;
+}
+
+/**
+ * Finds the k stations whose incoming flux is most reduced by deactivating some edges, in the same order as topReductions.
+ * A station's flux can only change if one of the edges is in its connected component, so only the stations of those
+ * components are max-flowed twice; the other ones have no reduction and their flux is only computed if they are needed
+ * to fill the k places
+ * Time Complexity: O(c|VE²|) (divided among the workers), c being the number of stations in the affected components
+ * @param edges - Edges to be deactivated
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param k - Number of stations wanted
+ * @param numWorkers - Number of threads computing fluxes at the same time
+ * @return The first min(k, |V|) elements of topReductions(edges, residualGraph)
+ */
+std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>>
+Graph::topKReductions(const std::vector<Edge *> &edges, Graph &residualGraph, unsigned int k, unsigned int numWorkers) {
+    updateComponents();
+    std::vector<bool> affectedComponent(componentEndOfLines.size(), false);
+    for (Edge const *e: edges) affectedComponent[getComponent(e->getOrig()->getIndex())] = true;
+
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> unaffected;
+    for (Vertex const *v: vertexSet) {
+        if (affectedComponent[getComponent(v->getIndex())]) candidates.push_back(v->getIndex());
+        else unaffected.push_back(v->getIndex());
+    }
+
+    // The same workers (and network copies) compute the reductions and the fluxes of the unaffected stations
+    std::unique_ptr<CopyWorkspace> workers = numWorkers > 1 ? std::make_unique<CopyWorkspace>(numWorkers) : nullptr;
+    std::vector<std::pair<Capacity, Capacity>> fluxes = incomingFluxReductions(candidates, edges, residualGraph,
+                                                                                       workers.get());
+    std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>> result;
+    for (unsigned int i = 0; i < candidates.size(); i++) result.push_back({vertexSet[candidates[i]]->getId(), fluxes[i]});
+    std::sort(result.begin(), result.end(), sort_reduction_decreasing);
+
+    // Past the reduced stations, every station (affected or not) has no reduction and they are ordered by name
+    auto firstUnreduced = std::find_if(result.begin(), result.end(), [](const auto &p) {
+        return reductionPercentage(p.second.first, p.second.second) <= 0;
+    });
+    if (firstUnreduced - result.begin() >= k) {
+        result.resize(k);
+        return result;
     }
 
-    std::sort(result.begin(), result.end(), [](const std::pair<std::string, std::pair<unsigned int, unsigned int>> &p1,
-                                               const std::pair<std::string, std::pair<unsigned int, unsigned int>> &p2) {
-        return (p1.second.first == 0 ? 0 : (100 - ((p1.second.second * 1.0) / p1.second.first) * 100)) >
-               (p2.second.first == 0 ? 0 : (100 - ((p2.second.second * 1.0) / p2.second.first) * 100));
+    std::sort(unaffected.begin(), unaffected.end(), [this](unsigned int v1, unsigned int v2) {
+        return vertexSet[v1]->getId() < vertexSet[v2]->getId();
     });
+    auto remaining = (unsigned int) (k - (firstUnreduced - result.begin()));
+    std::vector<std::string> unreducedNames;
+    for (auto it = firstUnreduced; it != result.end(); it++) unreducedNames.push_back(it->first);
+    std::vector<unsigned int> selected;
+    auto itName = unreducedNames.begin();
+    for (unsigned int v: unaffected) {
+        while (itName != unreducedNames.end() && *itName < vertexSet[v]->getId() && remaining > 0) {
+            itName++;
+            remaining--;
+        }
+        if (remaining == 0) break;
+        selected.push_back(v);
+        remaining--;
+    }
 
+    std::vector<Capacity> selectedFlows = incomingFluxes(selected, {}, residualGraph, workers.get());
+    for (unsigned int i = 0; i < selected.size(); i++)
+        result.push_back({vertexSet[selected[i]]->getId(), {selectedFlows[i], selectedFlows[i]}});
+    std::sort(result.begin(), result.end(), sort_reduction_decreasing);
+    if (result.size() > k) result.resize(k);
     return result;
 }
 
+/**
+ * Computes the incoming flux of several stations with some edges deactivated, using the threads of a workspace when
+ * there is one and this Graph otherwise
+ * Time Complexity: O(n|VE²|) (divided among the workers), n being the number of stations
+ * @param stations - Indexes of the stations
+ * @param edges - Edges to be deactivated during the computation
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param workers - Worker threads and their copies of this Graph, or nullptr to compute on this Graph
+ * @return The incoming flux of each station, in the same order as stations
+ */
+std::vector<Capacity>
+Graph::incomingFluxes(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges,
+                      Graph &residualGraph, CopyWorkspace *workers) {
+    if (workers != nullptr) return parallelIncomingFlux(stations, edges, *workers);
+
+    std::vector<Capacity> fluxes;
+    AppliedScenario failure(*this, edges);
+    for (unsigned int station: stations)
+        fluxes.push_back(edmondsKarp(getEndOfLines(getComponent(station)), station, residualGraph));
+    return fluxes;
+}
 
 /**
- * Creates a list with every vertex on the edges of the connected component of VertexId, excluding itself
- * Time Complexity: O(V)
- * @param vertexId - Id of Vertex to be excluded from the list
- * @return A list with every vertex id on the edges of the connected component except the one selected in the function
+ * Computes the incoming flux of several stations before and after deactivating some edges. The flux with the edges
+ * deactivated is found by repairing the flow of the original one (see warmMaxFlow), instead of from scratch. Uses the
+ * threads of a workspace when there is one and this Graph otherwise
+ * Time Complexity: O(n|VE²|) (divided among the workers), n being the number of stations
+ * @param stations - Indexes of the stations
+ * @param edges - Edges to be deactivated
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param workers - Worker threads and their copies of this Graph, or nullptr to compute on this Graph
+ * @return The original and reduced incoming flux of each station, in the same order as stations
  */
-std::list<std::string> Graph::superSourceCreator(const std::string &vertexId) const {
-    std::list<std::string> superSource = findEndOfLines(vertexId);
-    for (auto it = superSource.begin(); it != superSource.end(); it++)
-        if (*it == vertexId) {
-            superSource.erase(it);
-            break;
+std::vector<std::pair<Capacity, Capacity>>
+Graph::incomingFluxReductions(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges,
+                              Graph &residualGraph, CopyWorkspace *workers) {
+    std::vector<std::pair<Capacity, Capacity>> fluxes(stations.size());
+    auto computeReduction = [&stations, &fluxes](unsigned int i, Graph &graph, Graph &residual,
+                                                 const std::vector<Edge *> &rails) {
+        const std::vector<unsigned int> &endOfLines = graph.getEndOfLines(graph.getComponent(stations[i]));
+        fluxes[i].first = graph.warmMaxFlow(endOfLines, stations[i], residual);
+        AppliedScenario failure(graph, rails);
+        fluxes[i].second = graph.warmMaxFlow(endOfLines, stations[i], residual);
+    };
+
+    if (workers != nullptr) {
+        forEachOnCopies((unsigned int) stations.size(), *workers, [&](unsigned int i, Graph &graph, Graph &residual) {
+            computeReduction(i, graph, residual, graph.correspondingRails(edges));
+        });
+    } else {
+        for (unsigned int i = 0; i < stations.size(); i++) computeReduction(i, *this, residualGraph, edges);
+    }
+    return fluxes;
+}
+
+/**
+ * Computes the incoming flux of several stations at the same time, each worker thread using its own copy of the network
+ * Time Complexity: O(n|VE²|) (divided among the workers), plus O(w(|V|+|E|)) for the copies of the network not yet
+ * made, n being the number of stations and w the number of workers
+ * @param stations - Indexes of the stations
+ * @param edges - Edges to be deactivated during the computation (this Graph is left unchanged)
+ * @param workers - Worker threads and their copies of this Graph
+ * @return The incoming flux of each station, in the same order as stations
+ */
+std::vector<Capacity>
+Graph::parallelIncomingFlux(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges,
+                            CopyWorkspace &workers) const {
+    std::vector<Capacity> fluxes(stations.size());
+    forEachOnCopies((unsigned int) stations.size(), workers, [&](unsigned int i, Graph &graph, Graph &residual) {
+        AppliedScenario failure(graph, graph.correspondingRails(edges));
+        fluxes[i] = graph.incomingFlux(graph.vertexSet[stations[i]]->getId(), residual);
+    });
+    return fluxes;
+}
+
+/**
+ * Runs a task for every index from 0 to count - 1 on worker threads, each worker using its own copy of the network (see
+ * forEachOnCopies with a CopyWorkspace). The workers and their copies only last for this call
+ * Time Complexity: O(w(|V|+|E|)) for copying the network plus the time of the tasks, w being the number of workers
+ * @param count - Number of tasks
+ * @param numWorkers - Number of worker threads
+ * @param task - Function receiving the task's index and the worker's copies of this Graph and of its residual network
+ */
+void Graph::forEachOnCopies(unsigned int count, unsigned int numWorkers,
+                            const std::function<void(unsigned int, Graph &, Graph &)> &task) const {
+    if (count == 0) return;
+    CopyWorkspace workers(std::max(1u, std::min(numWorkers, count)));
+    forEachOnCopies(count, workers, task);
+}
+
+/**
+ * Runs a task for every index from 0 to count - 1 on the threads of a workspace, each worker using its own copy of the
+ * network (so that the flows it stores don't interfere with the other workers). A worker copies the network the first
+ * time it runs a task of the workspace and keeps the copy for the following calls. Indexes are handed to the workers one
+ * at a time, so that workers that got quick tasks take more of them. The workers' flow statistics are added to this
+ * thread's
+ * Time Complexity: O(w(|V|+|E|)) for the copies not yet made plus the time of the tasks, w being the number of workers
+ * @param count - Number of tasks
+ * @param workers - Worker threads and their copies of this Graph
+ * @param task - Function receiving the task's index and the worker's copies of this Graph and of its residual network
+ */
+void Graph::forEachOnCopies(unsigned int count, CopyWorkspace &workers,
+                            const std::function<void(unsigned int, Graph &, Graph &)> &task) const {
+    if (count == 0) return;
+    std::vector<FlowStatistics> workerStatistics(workers.copies.size());
+
+    for (unsigned int i = 0; i < count; i++) {
+        workers.pool.submit([&, i](unsigned int workerId) {
+            std::unique_ptr<std::pair<Graph, Graph>> &copy = workers.copies[workerId];
+            if (copy == nullptr) {
+                copy = std::make_unique<std::pair<Graph, Graph>>();
+                copyNetwork(copy->first, copy->second);
+            }
+
+            if (FlowStatistics::enabled()) flowStatistics.reset();
+            task(i, copy->first, copy->second);
+            if (FlowStatistics::enabled()) workerStatistics[workerId].merge(flowStatistics);
+        });
+    }
+    workers.pool.wait();
+
+    if (FlowStatistics::enabled())
+        for (const FlowStatistics &statistics: workerStatistics) flowStatistics.merge(statistics);
+}
+
+/**
+ * Finds the Edges of this Graph representing the same rails as Edges of another Graph with the same topology (e.g. a copy)
+ * Time Complexity: O(size(edges))
+ * @param edges - Edges of the other Graph
+ * @return Pointers to this Graph's Edges for the same rails
+ */
+std::vector<Edge *> Graph::correspondingRails(const std::vector<Edge *> &edges) const {
+    std::vector<Edge *> rails;
+    for (Edge const *e: edges) rails.push_back(edgeSet[e->getIndex()]);
+    return rails;
+}
+
+/**
+ * Labels the connected components of the network's topology (ignoring whether rails are deactivated) with an iterative BFS,
+ * and stores, for each component, the indexes of its end-of-line stations (i.e. those with only one connection). The
+ * result is kept until the topology changes
+ * Time Complexity: O(|V|+|E|) (if the topology changed since the last call) | O(1) (otherwise)
+ */
+void Graph::updateComponents() const {
+    if (componentsVersion == topologyVersion) return;
+
+    componentOf.assign(vertexSet.size(), UINT32_MAX);
+    componentEndOfLines.clear();
+    std::vector<Vertex *> stack;
+
+    for (Vertex *root: vertexSet) {
+        if (componentOf[root->getIndex()] != UINT32_MAX) continue;
+        auto component = (unsigned int) componentEndOfLines.size();
+        componentEndOfLines.emplace_back();
+
+        componentOf[root->getIndex()] = component;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            Vertex const *curr = stack.back();
+            stack.pop_back();
+            if (curr->getAdj().size() == 1) componentEndOfLines[component].push_back(curr->getIndex());
+            for (Edge const *e: curr->getAdj()) {
+                if (componentOf[e->getDest()->getIndex()] == UINT32_MAX) {
+                    componentOf[e->getDest()->getIndex()] = component;
+                    stack.push_back(e->getDest());
+                }
+            }
         }
-    return superSource;
+    }
+    componentsVersion = topologyVersion;
 }
 
 /**
- * DFS traversal variation that sets the visited attribute to true of the nodes the DFS traverses to
- * Time Complexity: O(|V|+|E|)
- * @param source - Vertex where the DFS starts
+ * Finds the connected component (of the network's topology) a vertex belongs to
+ * Time Complexity: O(1) (average case, after the components are computed)
+ * @param vertexIndex - Index of the Vertex
+ * @return Label of the Vertex's connected component
+ */
+unsigned int Graph::getComponent(unsigned int vertexIndex) const {
+    updateComponents();
+    return componentOf[vertexIndex];
+}
+
+/**
+ * Finds the end-of-line stations (i.e. those with only one connection) of a connected component
+ * Time Complexity: O(1) (after the components are computed)
+ * @param component - Label of the connected component
+ * @return Indexes of the component's end-of-line vertices
+ */
+const std::vector<unsigned int> &Graph::getEndOfLines(unsigned int component) const {
+    updateComponents();
+    return componentEndOfLines[component];
+}
+
+/**
+ * Labels the connected components formed by the active (selected) rails with a union-find over the rails. The labelling
+ * is kept until the topology or the set of deactivated rails changes
+ * Time Complexity: O((|V|+|E|) * α(|V|)) (if the network changed since the last call) | O(1) (otherwise)
  */
-void Graph::visitedDFS(Vertex *source) {
-    source->setVisited(true);
-    for (Edge const *e: source->getAdj()) {
-        if (!e->getDest()->isVisited()) {
-            visitedDFS(e->getDest());
+void Graph::updateActiveComponents() const {
+    std::pair<unsigned long long, unsigned long long> version = {topologyVersion, deactivatedHash};
+    if (activeComponentsVersion == version) return;
+
+    std::vector<unsigned int> parent(vertexSet.size());
+    std::vector<unsigned int> size(vertexSet.size(), 1);
+    for (unsigned int i = 0; i < parent.size(); i++) parent[i] = i;
+    auto find = [&parent](unsigned int v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    };
+
+    for (Edge const *e: edgeSet) {
+        if (!isRailActive(e->getIndex())) continue;
+        unsigned int a = find(e->getOrig()->getIndex()), b = find(e->getDest()->getIndex());
+        if (a == b) continue;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+    }
+
+    activeComponentOf.assign(vertexSet.size(), UINT32_MAX);
+    activeComponentMembers.clear();
+    std::vector<unsigned int> rootToComponent(vertexSet.size(), UINT32_MAX);
+    for (unsigned int v = 0; v < vertexSet.size(); v++) {
+        unsigned int root = find(v);
+        if (rootToComponent[root] == UINT32_MAX) {
+            rootToComponent[root] = (unsigned int) activeComponentMembers.size();
+            activeComponentMembers.emplace_back();
         }
+        activeComponentOf[v] = rootToComponent[root];
+        activeComponentMembers[rootToComponent[root]].push_back(v);
     }
+    activeComponentsVersion = version;
+}
+
+/**
+ * Finds the connected component, considering only the active rails, a vertex belongs to
+ * Time Complexity: O(1) (after the components are computed)
+ * @param vertexIndex - Index of the Vertex
+ * @return Label of the Vertex's connected component
+ */
+unsigned int Graph::getActiveComponent(unsigned int vertexIndex) const {
+    updateActiveComponents();
+    return activeComponentOf[vertexIndex];
 }
 
 /**
- * Finds the pairs of stations with max Max-Flow
+ * Finds the vertices of a connected component of the active rails
+ * Time Complexity: O(1) (after the components are computed)
+ * @param component - Label of the connected component
+ * @return Indexes of the component's vertices, in increasing order
+ */
+const std::vector<unsigned int> &Graph::getActiveComponentMembers(unsigned int component) const {
+    updateActiveComponents();
+    return activeComponentMembers[component];
+}
+
+/**
+ * Creates a list with every vertex on the edges of the connected component of VertexId, excluding itself
+ * Time Complexity: O(V)
+ * @param vertexId - Id of Vertex to be excluded from the list
+ * @return A list with every vertex id on the edges of the connected component except the one selected in the function
+ */
+std::list<std::string> Graph::superSourceCreator(const std::string &vertexId) const {
+    unsigned int index = findVertex(vertexId)->getIndex();
+    std::list<std::string> superSource;
+    for (unsigned int endOfLine: getEndOfLines(getComponent(index)))
+        if (endOfLine != index) superSource.push_back(vertexSet[endOfLine]->getId());
+    return superSource;
+}
+
+/**
+ * Finds the pairs of stations with max Max-Flow. Only pairs inside the same connected component of the active rails are
+ * considered, as any other pair cannot have flow between them
  * Time Complexity: O(|V³|*|E²|)
  * @param residualGraph - Graph object representing the graph's residual network
  * @return A pair consisting of a list of pairs, the stations with max-flow, and an unsigned int of the value of the max flow between them
  */
-std::pair<std::list<std::pair<std::string, std::string>>, unsigned int>
+std::pair<std::list<std::pair<std::string, std::string>>, Capacity>
 Graph::calculateNetworkMaxFlow(Graph &residualGraph) {
-    unsigned int max = 0;
+    Capacity max = 0;
     std::list<std::pair<std::string, std::string>> stationList;
-    for (auto itV1 = vertexSet.begin(); itV1 < vertexSet.end(); itV1++) {
-        Vertex *v1 = *itV1;
-        for (Vertex *aux: vertexSet) aux->setVisited(false);
-        visitedDFS(*itV1);
-        for (auto itV2 = itV1 + 1; itV2 < vertexSet.end(); itV2++) {
-            Vertex *v2 = *itV2;
-            if (v2->isVisited()) {
-                unsigned int itFlow = edmondsKarp({v1->getId()}, v2->getId(), residualGraph);
-                if (itFlow == max) stationList.emplace_back(v1->getId(), v2->getId());
-                if (itFlow > max) {
-                    max = itFlow;
-                    stationList = {{v1->getId(), v2->getId()}};
-                }
+    for (Vertex const *v1: vertexSet) {
+        const std::vector<unsigned int> &members = getActiveComponentMembers(getActiveComponent(v1->getIndex()));
+        auto itV2 = std::upper_bound(members.begin(), members.end(), v1->getIndex());
+        for (; itV2 != members.end(); itV2++) {
+            Vertex const *v2 = vertexSet[*itV2];
+            Capacity itFlow = edmondsKarp({v1->getIndex()}, v2->getIndex(), residualGraph);
+            if (itFlow == max) stationList.emplace_back(v1->getId(), v2->getId());
+            if (itFlow > max) {
+                max = itFlow;
+                stationList = {{v1->getId(), v2->getId()}};
             }
         }
     }
@@ -522,15 +2137,16 @@ Graph::calculateNetworkMaxFlow(Graph &residualGraph) {
 }
 
 /**
- * Finds the incoming flux that a certain station can receive (i.e the amount of trains that can arrive there at the same time)
+ * Finds the incoming flux that a certain station can receive (i.e the amount of trains that can arrive there at the same time),
+ * using the precomputed end-of-line stations of its connected component as a super source
  * Time Complexity: O(|VE²|)
  * @param station - Vertex's ID
  * @param residualGraph - Graph object representing the graph's residual network
  * @return Max flow that can arrive at the given vertex from all the network
  */
-unsigned int Graph::incomingFlux(const std::string &station, Graph &residualGraph) {
-    std::list<std::string> superSource = superSourceCreator(station);
-    return edmondsKarp(superSource, station, residualGraph);
+Capacity Graph::incomingFlux(const std::string &station, Graph &residualGraph) {
+    unsigned int index = findVertex(station)->getIndex();
+    return edmondsKarp(getEndOfLines(getComponent(index)), index, residualGraph);
 }
 
 /**
@@ -541,52 +2157,223 @@ unsigned int Graph::incomingFlux(const std::string &station, Graph &residualGrap
  * @param residualGraph - Graph object representing the graph's residual network
  * @return Max flow that can arrive at the given vertex from all the network
  */
-unsigned int
+Capacity
 Graph::incomingReducedFlux(const std::vector<Edge *> &edges, const std::string &station, Graph &residualGraph) {
-    std::list<std::string> superSource = superSourceCreator(station);
-    deactivateEdges(edges);
-    unsigned int result = edmondsKarp(superSource, station, residualGraph);
-    activateEdges(edges);
-    return result;
+    unsigned int index = findVertex(station)->getIndex();
+    AppliedScenario failure(*this, edges);
+    return edmondsKarp(getEndOfLines(getComponent(index)), index, residualGraph);
 }
 
 
 bool
 sort_pair_decreasing_second(const std::pair<std::string, double> &left, const std::pair<std::string, double> &right) {
-    return left.second > right.second;
+    if (left.second != right.second) return left.second > right.second;
+    return left.first < right.first;
 }
 
 /**
  * Creates an ordered vector with incoming fluxes of previously grouped stations
  * Time Complexity: O(|V²E²| * m), with m being the size of group
- * @param group - Map that identifies a group of stations
+ * @param group - Grouping of the stations
  * @param residualGraph - Graph object representing the graph's residual network
+ * @param numWorkers - Number of threads computing fluxes at the same time
  * @return An ordered vector of pairs with decreasing average flow (second element), identified by its grouping name (first element)
  */
 std::vector<std::pair<std::string, double>>
-Graph::topGroupings(const std::unordered_map<std::string, std::list<Station>> &group, Graph &residualGraph) {
+Graph::topGroupings(const StationGrouping &group, Graph &residualGraph, unsigned int numWorkers) {
+    std::unordered_map<std::string, Capacity> fluxCache;
+    return topGroupings(group, residualGraph, fluxCache, numWorkers);
+}
+
+/**
+ * Creates an ordered vector with incoming fluxes of previously grouped stations, reusing (and filling) a cache of already
+ * computed incoming fluxes, so that several groupings of the same network only compute each station's flux once. Ties
+ * are ordered by grouping name
+ * Time Complexity: O(|V²E²|) (for the stations not yet in fluxCache, divided among the workers)
+ * @param group - Grouping of the stations
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param fluxCache - Map from station id to its already computed incoming flux
+ * @param numWorkers - Number of threads computing fluxes at the same time (with 1, the computation is done on this Graph)
+ * @return An ordered vector of pairs with decreasing average flow (second element), identified by its grouping name (first element)
+ */
+std::vector<std::pair<std::string, double>>
+Graph::topGroupings(const StationGrouping &group, Graph &residualGraph,
+                    std::unordered_map<std::string, Capacity> &fluxCache, unsigned int numWorkers) {
+    if (numWorkers > 1) {
+        std::vector<unsigned int> missing;
+        std::vector<bool> queued(vertexSet.size(), false);
+        for (unsigned int g = 0; g < group.size(); g++) {
+            for (unsigned int id: group.getStations(g)) {
+                const std::string &name = group.getStation(id).getName();
+                Vertex const *v = findVertex(name);
+                if (v == nullptr || queued[v->getIndex()] || fluxCache.count(name)) continue;
+                queued[v->getIndex()] = true;
+                missing.push_back(v->getIndex());
+            }
+        }
+        CopyWorkspace workers(std::max(1u, std::min(numWorkers, (unsigned int) missing.size())));
+        std::vector<Capacity> fluxes = parallelIncomingFlux(missing, {}, workers);
+        for (unsigned int i = 0; i < missing.size(); i++) fluxCache.emplace(vertexSet[missing[i]]->getId(), fluxes[i]);
+    }
+
     std::vector<std::pair<std::string, double>> result;
-    for (const auto &it: group) {
-        double average = getAverageIncomingFlux(it.second, residualGraph);
-        result.emplace_back(it.first, average);
+    for (unsigned int g = 0; g < group.size(); g++) {
+        if (group.getStations(g).empty()) continue;
+        result.emplace_back(group.getName(g), getAverageIncomingFlux(group, g, residualGraph, fluxCache));
     }
     std::sort(result.begin(), result.end(), sort_pair_decreasing_second);
     return result;
 }
 
 /**
- * Finds the average incoming flux for every station in a list (normally, representing a township, etc.)
- * Time Complexity: O(n|VE²|), n being the size of stations
- * @param stations - List with the stations' id
+ * Finds the k groupings with the highest average incoming flux, in the same order as topGroupings. Groupings are visited
+ * in decreasing order of an upper bound of their average (a station's incoming flux can't exceed the capacity of the
+ * rails arriving at it), and the search stops once the k-th best average found is above the bound of the next grouping,
+ * so the stations of groupings that can't enter the top k are never max-flowed. Stations missing from the network (e.g.
+ * ones whose Vertex couldn't be added) count as receiving no flux
+ * Time Complexity: O(|V²E²|) (worst case, for the stations not yet in fluxCache, divided among the workers)
+ * @param group - Grouping of the stations
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param fluxCache - Map from station id to its already computed incoming flux
+ * @param k - Number of groupings wanted
+ * @param numWorkers - Number of threads computing fluxes at the same time
+ * @return The first min(k, size(group)) elements of topGroupings(group, residualGraph)
+ */
+std::vector<std::pair<std::string, double>>
+Graph::topKGroupings(const StationGrouping &group, Graph &residualGraph,
+                     std::unordered_map<std::string, Capacity> &fluxCache, unsigned int k,
+                     unsigned int numWorkers) {
+    std::vector<std::pair<std::string, double>> result;
+    if (k == 0) return result;
+
+    std::vector<std::pair<unsigned int, double>> bounds; // grouping id and bound of its average
+    for (unsigned int g = 0; g < group.size(); g++) {
+        StationSpan stations = group.getStations(g);
+        if (stations.empty()) continue;
+        FlowSum boundSum = 0;
+        for (unsigned int id: stations) {
+            const std::string &name = group.getStation(id).getName();
+            auto cached = fluxCache.find(name);
+            if (cached != fluxCache.end()) boundSum += cached->second;
+            else if (Vertex const *v = findVertex(name)) boundSum += incomingCapacity(v);
+        }
+        bounds.emplace_back(g, (double) boundSum / (double) stations.size());
+    }
+    std::sort(bounds.begin(), bounds.end(), [&group](const auto &left, const auto &right) {
+        if (left.second != right.second) return left.second > right.second;
+        return group.getName(left.first) < group.getName(right.first);
+    });
+
+    // Created once, so that the network is copied only once per worker across all batches
+    std::unique_ptr<CopyWorkspace> workers = numWorkers > 1 ? std::make_unique<CopyWorkspace>(numWorkers) : nullptr;
+    size_t next = 0;
+    while (next < bounds.size() && (result.size() < k || result[k - 1].second <= bounds[next].second)) {
+        size_t end = next + 1;
+        if (numWorkers > 1) {
+            // Gather enough groupings to keep every worker busy
+            std::vector<unsigned int> missing;
+            std::unordered_set<unsigned int> queued;
+            for (end = next; end < bounds.size() && missing.size() < 4 * (size_t) numWorkers; end++) {
+                for (unsigned int id: group.getStations(bounds[end].first)) {
+                    const std::string &name = group.getStation(id).getName();
+                    Vertex const *v = findVertex(name);
+                    if (v != nullptr && !fluxCache.count(name) && queued.insert(v->getIndex()).second)
+                        missing.push_back(v->getIndex());
+                }
+            }
+            std::vector<Capacity> fluxes = parallelIncomingFlux(missing, {}, *workers);
+            for (unsigned int i = 0; i < missing.size(); i++)
+                fluxCache.emplace(vertexSet[missing[i]]->getId(), fluxes[i]);
+        }
+
+        for (; next < end; next++)
+            result.emplace_back(group.getName(bounds[next].first),
+                                getAverageIncomingFlux(group, bounds[next].first, residualGraph, fluxCache));
+        std::sort(result.begin(), result.end(), sort_pair_decreasing_second);
+        if (result.size() > k) result.resize(k);
+    }
+    return result;
+}
+
+/**
+ * Upper bound of the incoming flux of a station: the total capacity of the active rails arriving at it
+ * Time Complexity: O(degree(v))
+ * @param v - Pointer to the station's Vertex
+ * @return Sum of the capacities of the Vertex's active incoming edges
+ */
+FlowSum Graph::incomingCapacity(Vertex const *v) const {
+    FlowSum capacity = 0;
+    for (Edge const *e: v->getIncoming())
+        if (isRailActive(e->getIndex())) capacity += e->getCapacity();
+    return capacity;
+}
+
+/**
+ * Finds the incoming flux of every station of a table, reusing (and filling) a cache of already computed fluxes, as the
+ * per-station metric of regional reports (see RegionHierarchy)
+ * Time Complexity: O(n|VE²|) (divided among the workers), n being the number of stations not yet in fluxCache
+ * @param stations - Stations, indexed by id
  * @param residualGraph - Graph object representing the graph's residual network
+ * @param fluxCache - Map from station id to its already computed incoming flux
+ * @param numWorkers - Number of threads computing fluxes at the same time
+ * @return The incoming flux of each station id (0 for stations not in this Graph)
  */
-double Graph::getAverageIncomingFlux(const std::list<Station> &stations, Graph &residualGraph) {
-    double flux_sum = 0;
+std::vector<double> Graph::stationFluxes(const std::vector<Station> &stations, Graph &residualGraph,
+                                         std::unordered_map<std::string, Capacity> &fluxCache,
+                                         unsigned int numWorkers) {
+    std::vector<unsigned int> missing;
     for (const Station &s: stations) {
-        const std::string &sid = s.getName();
-        flux_sum += incomingFlux(sid, residualGraph);
+        Vertex const *v = findVertex(s.getName());
+        if (v != nullptr && !fluxCache.count(s.getName())) missing.push_back(v->getIndex());
+    }
+    std::unique_ptr<CopyWorkspace> workers =
+            numWorkers > 1 && !missing.empty() ? std::make_unique<CopyWorkspace>(numWorkers) : nullptr;
+    std::vector<Capacity> fluxes = incomingFluxes(missing, {}, residualGraph, workers.get());
+    for (unsigned int i = 0; i < missing.size(); i++) fluxCache.emplace(vertexSet[missing[i]]->getId(), fluxes[i]);
+
+    std::vector<double> result(stations.size(), 0);
+    for (const Station &s: stations) {
+        auto it = fluxCache.find(s.getName());
+        if (it != fluxCache.end()) result[s.getId()] = it->second;
+    }
+    return result;
+}
+
+/**
+ * Finds the average incoming flux for every station in a grouping (normally, representing a township, etc.)
+ * Time Complexity: O(n|VE²|), n being the number of stations of the grouping
+ * @param group - Grouping of the stations
+ * @param grouping - Id of the grouping
+ * @param residualGraph - Graph object representing the graph's residual network
+ */
+double Graph::getAverageIncomingFlux(const StationGrouping &group, unsigned int grouping, Graph &residualGraph) {
+    std::unordered_map<std::string, Capacity> fluxCache;
+    return getAverageIncomingFlux(group, grouping, residualGraph, fluxCache);
+}
+
+/**
+ * Finds the average incoming flux for every station in a grouping, reusing (and filling) a cache of already computed
+ * fluxes
+ * Time Complexity: O(n|VE²|), n being the number of stations of the grouping not yet in fluxCache
+ * @param group - Grouping of the stations
+ * @param grouping - Id of the grouping
+ * @param residualGraph - Graph object representing the graph's residual network
+ * @param fluxCache - Map from station id to its already computed incoming flux
+ */
+double Graph::getAverageIncomingFlux(const StationGrouping &group, unsigned int grouping, Graph &residualGraph,
+                                     std::unordered_map<std::string, Capacity> &fluxCache) {
+    StationSpan stations = group.getStations(grouping);
+    FlowSum flux_sum = 0;
+    for (unsigned int id: stations) {
+        const std::string &sid = group.getStation(id).getName();
+        auto it = fluxCache.find(sid);
+        if (it == fluxCache.end()) {
+            if (findVertex(sid) == nullptr) continue; // not in the network, so no train can arrive at it
+            it = fluxCache.emplace(sid, incomingFlux(sid, residualGraph)).first;
+        }
+        flux_sum += it->second;
     }
-    return flux_sum / (double) stations.size();
+    return (double) flux_sum / (double) stations.size();
 }
 
 /**
@@ -603,7 +2390,8 @@ void Graph::makeMinCostResidual(Graph &minCostResidual) {
             auto [edge, negativeCostEdge] = minCostResidual.addAndGetBidirectionalEdge(
                     e->getOrig()->getId(), e->getDest()->getId(), e->getCapacity(), e->getService());
 
-            negativeCostEdge->setCost(-edge->getCost());
+            edge->setCost(e->getCost());
+            negativeCostEdge->setCost(-e->getCost());
 
             edge->setCapacity(e->getCapacity() - e->getFlow());
             negativeCostEdge->setCapacity(e->getFlow());
@@ -13,20 +13,140 @@
 #include <tuple>
 #include <list>
 #include <algorithm>
-#include <list>
+#include <memory>
+#include <unordered_set>
+#include <functional>
 
 #include "vertex.h"
 #include "station.h"
+#include "stationGrouping.h"
+#include "flowStatistics.h"
+#include "flowTypes.h"
+#include "serviceCostModel.h"
+#include "scenario.h"
+#include "terminalArcs.h"
+#include "multiCommodityFlow.h"
+#include "threadPool.h"
+
+enum class MaxFlowEngine : unsigned int {
+    EDMONDS_KARP = 0,
+    CAPACITY_SCALING = 1,
+    BOYKOV_KOLMOGOROV = 2
+};
+
+enum class PathSearch : unsigned int {
+    BFS = 0,
+    BIDIRECTIONAL = 1
+};
+
+struct FlowPath {
+    std::vector<Edge *> edges; // from a source to the target
+    Capacity trains = 0;
+};
+
+struct FlowDecomposition {
+    Capacity value = 0;
+    std::vector<std::pair<Edge *, Capacity>> edgeFlows; // every edge carrying flow, with its flow
+    std::vector<FlowPath> paths;
+};
+
+struct TerminalFlow {
+    unsigned int vertex = 0;
+    Capacity capacity = INFINITE_CAPACITY; // supply of a source or demand of a sink
+    Capacity flow = 0; // flow leaving the source or reaching the sink
+};
+
+struct MultiTerminalFlow {
+    Capacity value = 0;
+    std::vector<TerminalFlow> sources;
+    std::vector<TerminalFlow> sinks;
+};
+
+struct FailureScenario {
+    std::vector<Edge *> rails;
+    Capacity flow = 0;
+};
+
+struct FailureAnalysis {
+    Capacity original = 0;
+    std::vector<FailureScenario> worst; // worst scenario with at most 1, 2, ..., k failed rails
+    unsigned long long evaluated = 0; // failure sets whose max flow was computed
+};
+
+// Percentage of a flow that is lost when it goes from base to reduced
+double reductionPercentage(Capacity base, Capacity reduced);
+
+struct CopyWorkspace;
 
 class Graph {
   private:
     unsigned int totalEdges = 0;
     std::vector<Vertex *> vertexSet;    // vertex set
+    std::vector<Edge *> edgeSet;    // one edge per rail, in insertion order
     std::unordered_map<std::string, Vertex *> idToVertex;
+    unsigned long long topologyVersion = 0; // incremented on every change to the vertices or rails
+    unsigned long long deactivatedHash = 0; // order-independent hash of the set of deactivated rails
+    // one bit per rail, set while the rail is active; shared with the residual network (see shareRailActivation)
+    std::shared_ptr<std::vector<unsigned long long>> activeRails = std::make_shared<std::vector<unsigned long long>>();
+    unsigned long long costHash = 0; // hash of the costs of the rails, set by applyCostModel
+
+    // connected components of the topology, computed on demand for topologyVersion
+    mutable unsigned long long componentsVersion = std::numeric_limits<unsigned long long>::max();
+    mutable std::vector<unsigned int> componentOf;
+    mutable std::vector<std::vector<unsigned int>> componentEndOfLines;
+
+    // connected components over the active rails only, computed on demand for topologyVersion and deactivatedHash
+    mutable std::pair<unsigned long long, unsigned long long> activeComponentsVersion =
+            {std::numeric_limits<unsigned long long>::max(), 0};
+    mutable std::vector<unsigned int> activeComponentOf;
+    mutable std::vector<std::vector<unsigned int>> activeComponentMembers;
+
+    unsigned long long flowResets = 0; // incremented by resetFlows, so that warmMaxFlow knows its flow was overwritten
+
+    // flow left by the last warmMaxFlow call, and what it was computed for
+    struct WarmStart {
+        bool valid = false;
+        Graph *residualGraph = nullptr;
+        std::vector<unsigned int> source;
+        unsigned int target = 0;
+        unsigned long long topologyVersion = 0;
+        unsigned long long flowResets = 0;
+        std::vector<unsigned long long> activeRails; // rail activation bitset
+        bool hasTrees = false; // whether it was left by boykovKolmogorov, along with its search trees
+        std::vector<unsigned char> tree;
+        std::vector<Edge *> parent;
+    } warmStart;
+
+    bool reuseWarmFlow(const std::vector<unsigned int> &sortedSource, unsigned int target, Graph &residualGraph);
+
+    Capacity recordWarmFlow(const std::vector<unsigned int> &sortedSource, unsigned int target,
+                                Graph &residualGraph);
+
+    [[nodiscard]] std::vector<unsigned int> loadedRails() const;
+
+    void searchFailures(const std::vector<unsigned int> &sortedSource, unsigned int target, Graph &residualGraph,
+                        unsigned int k, unsigned int rail, std::vector<unsigned int> &chosen,
+                        std::vector<bool> &excluded,
+                        std::vector<std::pair<std::vector<unsigned int>, Capacity>> &worst,
+                        unsigned long long &evaluated);
+
+    Capacity growSearchTrees(Graph &residualGraph, TerminalArcs &terminals, bool reused);
+
+    void updateComponents() const;
+
+    void updateActiveComponents() const;
+
+    static unsigned long long railHash(unsigned int index);
 
   public:
     Graph();
 
+    ~Graph();
+
+    Graph(const Graph &) = delete;
+
+    Graph &operator=(const Graph &) = delete;
+
     [[nodiscard]] Vertex *findVertex(const std::string &id) const;
 
     bool addVertex(const std::string &id);
@@ -37,60 +157,202 @@ class Graph {
 
     std::vector<Edge *> randomlySelectEdges(unsigned int numEdges);
 
-    static void activateEdges(const std::vector<Edge *> &Edges);
+    void activateEdges(const std::vector<Edge *> &Edges);
 
     std::list<std::string> superSourceCreator(const std::string &vertexId) const;
 
-    [[nodiscard]] unsigned int incomingFlux(const std::string &station, Graph &residualGraph);
+    [[nodiscard]] Capacity incomingFlux(const std::string &station, Graph &residualGraph);
+
+    Capacity edmondsKarp(const std::list<std::string> &source, const std::string &target, Graph &residualGraph);
+
+    Capacity edmondsKarp(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                             PathSearch search = PathSearch::BFS);
+
+    Capacity capacityScaling(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                                 PathSearch search = PathSearch::BFS);
+
+    Capacity maxFlow(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                         MaxFlowEngine engine, PathSearch search = PathSearch::BFS);
+
+    Capacity maxFlow(const std::list<std::string> &source, const std::string &target, Graph &residualGraph,
+                         MaxFlowEngine engine, PathSearch search = PathSearch::BFS);
+
+    MultiTerminalFlow multiTerminalMaxFlow(const std::vector<TerminalFlow> &sources,
+                                           const std::vector<TerminalFlow> &sinks, Graph &residualGraph,
+                                           MaxFlowEngine engine = MaxFlowEngine::EDMONDS_KARP);
+
+    ConcurrentFlow maxConcurrentFlow(const std::vector<Commodity> &commodities, Graph &residualGraph,
+                                     double epsilon = 0.1);
+
+    [[nodiscard]] FlowDecomposition decomposeFlow(const std::vector<unsigned int> &source, unsigned int target) const;
+
+    FlowDecomposition maxFlowDecomposition(const std::list<std::string> &source, const std::string &target,
+                                           Graph &residualGraph, MaxFlowEngine engine = MaxFlowEngine::EDMONDS_KARP,
+                                           PathSearch search = PathSearch::BFS);
+
+    void resetFlows();
+
+    Capacity warmMaxFlow(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                             PathSearch search = PathSearch::BFS);
 
-    unsigned int edmondsKarp(const std::list<std::string> &source, const std::string &target, Graph &residualGraph);
+    Capacity boykovKolmogorov(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                                  bool reuseTrees = false);
 
-    std::pair<std::list<std::pair<std::string, std::string>>, unsigned int>
+    void restoreConservation(std::vector<long long> &imbalance, const std::vector<bool> &terminal,
+                             const std::vector<unsigned int> &source, unsigned int target) const;
+
+    bool pathToAny(unsigned int source, const std::vector<bool> &terminal, unsigned int &reached) const;
+
+    bool terminalPath(const TerminalArcs &terminals, Capacity minCapacity, unsigned int &reached) const;
+
+    std::pair<std::list<std::pair<std::string, std::string>>, Capacity>
     calculateNetworkMaxFlow(Graph &residualGraph);
 
     [[nodiscard]] unsigned int getTotalEdges() const;
 
-    void augmentPath(const std::string &target, const unsigned int &value) const;
+    [[nodiscard]] unsigned long long getTopologyVersion() const;
+
+    [[nodiscard]] unsigned long long getDeactivatedHash() const;
+
+    [[nodiscard]] unsigned long long getCostHash() const;
+
+    void copyNetwork(Graph &graphCopy, Graph &residualCopy) const;
+
+    void augmentPath(const std::string &target, const Capacity &value) const;
+
+    void augmentPath(unsigned int target, const Capacity &value) const;
+
+    Capacity augmentTerminalPath(unsigned int sink, TerminalArcs &terminals) const;
 
     bool path(const std::list<std::string> &source, const std::string &target) const;
 
+    bool path(const std::vector<unsigned int> &source, unsigned int target, Capacity minCapacity = 1) const;
+
+    bool bidirectionalPath(const std::vector<unsigned int> &source, unsigned int target,
+                           Capacity minCapacity = 1) const;
+
+    bool augmentingPath(const std::vector<unsigned int> &source, unsigned int target, Capacity minCapacity,
+                        PathSearch search) const;
+
     std::pair<Edge *, Edge *>
-    addAndGetBidirectionalEdge(const std::string &source, const std::string &dest, unsigned int c, Service service);
+    addAndGetBidirectionalEdge(const std::string &source, const std::string &dest, Capacity c, Service service,
+                               unsigned int length = 0);
+
+    void applyCostModel(const ServiceCostModel &costModel);
 
-    std::pair<unsigned int, unsigned int>
+    std::pair<Capacity, Cost>
 
     minCostMaxFlow(const std::string &source, const std::string &target, Graph &residualGraph);
 
-    static unsigned int findListBottleneck(const std::list<Edge *> &edges);
+    static Capacity findListBottleneck(const std::list<Edge *> &edges);
 
     void makeMinCostResidual(Graph &minCostResidual);
 
-    static void augmentMinCostPath(const std::list<Edge *> &edges, const unsigned int &value);
+    static void augmentMinCostPath(const std::list<Edge *> &edges, const Capacity &value);
+
+    std::vector<std::pair<std::string, double>>
+    topGroupings(const StationGrouping &group, Graph &residualGraph, unsigned int numWorkers = 1);
+
+    std::vector<std::pair<std::string, double>>
+    topGroupings(const StationGrouping &group, Graph &residualGraph,
+                 std::unordered_map<std::string, Capacity> &fluxCache, unsigned int numWorkers = 1);
 
     std::vector<std::pair<std::string, double>>
-    topGroupings(const std::unordered_map<std::string, std::list<Station>> &group, Graph &residualGraph);
+    topKGroupings(const StationGrouping &group, Graph &residualGraph,
+                  std::unordered_map<std::string, Capacity> &fluxCache, unsigned int k, unsigned int numWorkers = 1);
 
-    double getAverageIncomingFlux(const std::list<Station> &stations, Graph &residualGraph);
+    [[nodiscard]] FlowSum incomingCapacity(Vertex const *v) const;
+
+    std::vector<double> stationFluxes(const std::vector<Station> &stations, Graph &residualGraph,
+                                      std::unordered_map<std::string, Capacity> &fluxCache,
+                                      unsigned int numWorkers = 1);
+
+    double getAverageIncomingFlux(const StationGrouping &group, unsigned int grouping, Graph &residualGraph);
+
+    double getAverageIncomingFlux(const StationGrouping &group, unsigned int grouping, Graph &residualGraph,
+                                  std::unordered_map<std::string, Capacity> &fluxCache);
 
     std::list<Edge *> bellmanFord(const std::string &source);
 
-    void visitedDFS(Vertex *source);
+    [[nodiscard]] Capacity findBottleneck(const std::string &target) const;
+
+    [[nodiscard]] Capacity findBottleneck(unsigned int target) const;
+
+    [[nodiscard]] unsigned int getComponent(unsigned int vertexIndex) const;
 
-    [[nodiscard]] unsigned int findBottleneck(const std::string &target) const;
+    [[nodiscard]] const std::vector<unsigned int> &getEndOfLines(unsigned int component) const;
+
+    [[nodiscard]] unsigned int getActiveComponent(unsigned int vertexIndex) const;
+
+    [[nodiscard]] const std::vector<unsigned int> &getActiveComponentMembers(unsigned int component) const;
 
     [[nodiscard]] std::list<std::string> findEndOfLines(const std::string &stationId) const;
 
-    std::pair<unsigned int, unsigned int>
+    std::pair<Capacity, Capacity>
     maxFlowDeactivatedEdges(const std::vector<Edge *> &selectedEdges, const std::list<std::string> &source,
-                            const std::string &target, Graph &residualGraph);
+                            const std::string &target, Graph &residualGraph,
+                            MaxFlowEngine engine = MaxFlowEngine::EDMONDS_KARP, PathSearch search = PathSearch::BFS);
+
+    FailureAnalysis worstFailures(const std::vector<unsigned int> &source, unsigned int target, Graph &residualGraph,
+                                  unsigned int k, unsigned int numWorkers = 1);
 
-    unsigned int
+    Capacity
     incomingReducedFlux(const std::vector<Edge *> &edges, const std::string &station, Graph &residualGraph);
 
-    static void deactivateEdges(const std::vector<Edge *> &edges);
+    void deactivateEdges(const std::vector<Edge *> &edges);
+
+    std::vector<unsigned long long> deactivateRails(const std::vector<unsigned long long> &mask);
+
+    void activateRails(const std::vector<unsigned long long> &mask);
+
+    [[nodiscard]] bool isRailActive(unsigned int rail) const;
+
+    [[nodiscard]] const std::vector<unsigned long long> &getActiveRails() const;
+
+    void shareRailActivation(Graph &residualGraph) const;
+
+    [[nodiscard]] Edge *getRail(unsigned int index) const;
+
+    void setRailCapacities(const std::vector<std::pair<Edge *, Capacity>> &capacities);
+
+    [[nodiscard]] std::vector<Capacity>
+    scenarioMaxFlows(const std::vector<Scenario> &scenarios, const std::vector<unsigned int> &source,
+                     unsigned int target, unsigned int numWorkers = 1) const;
+
+    std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>>
+    topReductions(const std::vector<Edge *> &edges, Graph &residualGraph, unsigned int numWorkers = 1);
+
+    std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>>
+    topKReductions(const std::vector<Edge *> &edges, Graph &residualGraph, unsigned int k, unsigned int numWorkers = 1);
+
+    std::vector<std::pair<Capacity, Capacity>>
+    incomingFluxReductions(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges,
+                           Graph &residualGraph, CopyWorkspace *workers);
+
+    void forEachOnCopies(unsigned int count, unsigned int numWorkers,
+                         const std::function<void(unsigned int, Graph &, Graph &)> &task) const;
+
+    void forEachOnCopies(unsigned int count, CopyWorkspace &workers,
+                         const std::function<void(unsigned int, Graph &, Graph &)> &task) const;
+
+    [[nodiscard]] std::vector<Edge *> correspondingRails(const std::vector<Edge *> &edges) const;
+
+    std::vector<Capacity>
+    incomingFluxes(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges, Graph &residualGraph,
+                   CopyWorkspace *workers);
+
+    [[nodiscard]] std::vector<Capacity>
+    parallelIncomingFlux(const std::vector<unsigned int> &stations, const std::vector<Edge *> &edges,
+                         CopyWorkspace &workers) const;
+};
+
+// Worker threads and their copies of a Graph (and of its residual network), kept across several forEachOnCopies calls.
+// Copies are made on first use, so a workspace must not outlive changes to the original network
+struct CopyWorkspace {
+    explicit CopyWorkspace(unsigned int numWorkers) : pool(numWorkers), copies(numWorkers) {}
 
-    std::vector<std::pair<std::string, std::pair<unsigned int, unsigned int>>>
-    topReductions(const std::vector<Edge *> &edges, Graph &residualGraph);
+    ThreadPool pool;
+    std::vector<std::unique_ptr<std::pair<Graph, Graph>>> copies; // graph and residual network of each worker
 };
 
 
@@ -0,0 +1,386 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cctype>
+#include "jsonValue.h"
+
+JsonValue::JsonValue() = default;
+
+JsonValue::JsonValue(bool boolean) : type(Type::BOOLEAN), boolean(boolean) {}
+
+JsonValue::JsonValue(double number) : type(Type::NUMBER), number(number) {}
+
+JsonValue::JsonValue(unsigned int number) : type(Type::NUMBER), number(number) {}
+
+JsonValue::JsonValue(int number) : type(Type::NUMBER), number(number) {}
+
+JsonValue::JsonValue(unsigned long long number) : type(Type::NUMBER), number((double) number) {}
+
+JsonValue::JsonValue(long long number) : type(Type::NUMBER), number((double) number) {}
+
+JsonValue::JsonValue(const std::string &string) : type(Type::STRING), string(string) {}
+
+JsonValue::JsonValue(const char *string) : type(Type::STRING), string(string) {}
+
+JsonValue JsonValue::array() {
+    JsonValue value;
+    value.type = Type::ARRAY;
+    return value;
+}
+
+JsonValue JsonValue::object() {
+    JsonValue value;
+    value.type = Type::OBJECT;
+    return value;
+}
+
+JsonValue::Type JsonValue::getType() const {
+    return type;
+}
+
+bool JsonValue::isNull() const {
+    return type == Type::NUL;
+}
+
+bool JsonValue::isNumber() const {
+    return type == Type::NUMBER;
+}
+
+bool JsonValue::isString() const {
+    return type == Type::STRING;
+}
+
+bool JsonValue::isArray() const {
+    return type == Type::ARRAY;
+}
+
+bool JsonValue::isObject() const {
+    return type == Type::OBJECT;
+}
+
+bool JsonValue::getBool() const {
+    if (type != Type::BOOLEAN) throw std::invalid_argument("JSON value is not a boolean");
+    return boolean;
+}
+
+double JsonValue::getNumber() const {
+    if (type != Type::NUMBER) throw std::invalid_argument("JSON value is not a number");
+    return number;
+}
+
+const std::string &JsonValue::getString() const {
+    if (type != Type::STRING) throw std::invalid_argument("JSON value is not a string");
+    return string;
+}
+
+const std::vector<JsonValue> &JsonValue::getArray() const {
+    if (type != Type::ARRAY) throw std::invalid_argument("JSON value is not an array");
+    return elements;
+}
+
+const std::vector<std::pair<std::string, JsonValue>> &JsonValue::getMembers() const {
+    if (type != Type::OBJECT) throw std::invalid_argument("JSON value is not an object");
+    return members;
+}
+
+/**
+ * Checks if this object has a member with the given key
+ * Time Complexity: O(m), m being the number of members of the object
+ * @param key - Key of the member
+ * @return True if this value is an object with such a member, false otherwise
+ */
+bool JsonValue::has(const std::string &key) const {
+    if (type != Type::OBJECT) return false;
+    for (const auto &member: members)
+        if (member.first == key) return true;
+    return false;
+}
+
+/**
+ * Finds the member of this object with the given key
+ * Time Complexity: O(m), m being the number of members of the object
+ * @param key - Key of the member
+ * @return Reference to the value of the member; throws std::invalid_argument if it doesn't exist
+ */
+const JsonValue &JsonValue::at(const std::string &key) const {
+    if (type == Type::OBJECT) {
+        for (const auto &member: members)
+            if (member.first == key) return member.second;
+    }
+    throw std::invalid_argument("Missing field \"" + key + "\"");
+}
+
+/**
+ * Appends a value to this array, turning a null value into an empty array first
+ * Time Complexity: O(1) (amortized)
+ * @param value - Value to append
+ */
+void JsonValue::push(const JsonValue &value) {
+    if (type == Type::NUL) type = Type::ARRAY;
+    elements.push_back(value);
+}
+
+/**
+ * Sets (or replaces) a member of this object, turning a null value into an empty object first
+ * Time Complexity: O(m), m being the number of members of the object
+ * @param key - Key of the member
+ * @param value - Value of the member
+ */
+void JsonValue::set(const std::string &key, const JsonValue &value) {
+    if (type == Type::NUL) type = Type::OBJECT;
+    for (auto &member: members) {
+        if (member.first == key) {
+            member.second = value;
+            return;
+        }
+    }
+    members.emplace_back(key, value);
+}
+
+/**
+ * Parses a JSON document
+ * Time Complexity: O(n), n being the length of the text
+ * @param text - Text to parse
+ * @return Parsed value; throws std::invalid_argument on malformed input
+ */
+JsonValue JsonValue::parse(const std::string &text) {
+    size_t pos = 0;
+    JsonValue value = parseValue(text, pos);
+    skipWhitespace(text, pos);
+    if (pos != text.size()) throw std::invalid_argument("Unexpected trailing characters in JSON");
+    return value;
+}
+
+void JsonValue::skipWhitespace(const std::string &text, size_t &pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        pos++;
+}
+
+JsonValue JsonValue::parseValue(const std::string &text, size_t &pos) {
+    skipWhitespace(text, pos);
+    if (pos >= text.size()) throw std::invalid_argument("Unexpected end of JSON");
+
+    char c = text[pos];
+    if (c == '{') {
+        JsonValue value = object();
+        pos++;
+        skipWhitespace(text, pos);
+        if (pos < text.size() && text[pos] == '}') {
+            pos++;
+            return value;
+        }
+        while (true) {
+            skipWhitespace(text, pos);
+            std::string key = parseString(text, pos);
+            skipWhitespace(text, pos);
+            if (pos >= text.size() || text[pos] != ':') throw std::invalid_argument("Expected ':' in JSON object");
+            pos++;
+            value.set(key, parseValue(text, pos));
+            skipWhitespace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                return value;
+            }
+            throw std::invalid_argument("Expected ',' or '}' in JSON object");
+        }
+    }
+    if (c == '[') {
+        JsonValue value = array();
+        pos++;
+        skipWhitespace(text, pos);
+        if (pos < text.size() && text[pos] == ']') {
+            pos++;
+            return value;
+        }
+        while (true) {
+            value.push(parseValue(text, pos));
+            skipWhitespace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return value;
+            }
+            throw std::invalid_argument("Expected ',' or ']' in JSON array");
+        }
+    }
+    if (c == '"') return {parseString(text, pos)};
+    if (text.compare(pos, 4, "true") == 0) {
+        pos += 4;
+        return {true};
+    }
+    if (text.compare(pos, 5, "false") == 0) {
+        pos += 5;
+        return {false};
+    }
+    if (text.compare(pos, 4, "null") == 0) {
+        pos += 4;
+        return {};
+    }
+
+    size_t end = pos;
+    while (end < text.size() && (isdigit(text[end]) || text[end] == '-' || text[end] == '+' || text[end] == '.' ||
+                                 text[end] == 'e' || text[end] == 'E'))
+        end++;
+    if (end == pos) throw std::invalid_argument(std::string("Unexpected character '") + c + "' in JSON");
+    double number = std::stod(text.substr(pos, end - pos));
+    pos = end;
+    return {number};
+}
+
+std::string JsonValue::parseString(const std::string &text, size_t &pos) {
+    if (pos >= text.size() || text[pos] != '"') throw std::invalid_argument("Expected string in JSON");
+    pos++;
+    std::string result;
+    while (pos < text.size() && text[pos] != '"') {
+        char c = text[pos++];
+        if (c != '\\') {
+            result += c;
+            continue;
+        }
+        if (pos >= text.size()) break;
+        char escaped = text[pos++];
+        switch (escaped) {
+            case 'n':
+                result += '\n';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'u': {
+                if (pos + 4 > text.size()) throw std::invalid_argument("Invalid unicode escape in JSON");
+                unsigned int code = std::stoul(text.substr(pos, 4), nullptr, 16);
+                pos += 4;
+                if (code >= 0xD800 && code <= 0xDBFF && text.compare(pos, 2, "\\u") == 0) { //Surrogate pair
+                    unsigned int low = std::stoul(text.substr(pos + 2, 4), nullptr, 16);
+                    pos += 6;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                //Encode as UTF-8
+                if (code < 0x80) result += (char) code;
+                else if (code < 0x800) {
+                    result += (char) (0xC0 | (code >> 6));
+                    result += (char) (0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    result += (char) (0xE0 | (code >> 12));
+                    result += (char) (0x80 | ((code >> 6) & 0x3F));
+                    result += (char) (0x80 | (code & 0x3F));
+                } else {
+                    result += (char) (0xF0 | (code >> 18));
+                    result += (char) (0x80 | ((code >> 12) & 0x3F));
+                    result += (char) (0x80 | ((code >> 6) & 0x3F));
+                    result += (char) (0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                result += escaped;
+                break;
+        }
+    }
+    if (pos >= text.size()) throw std::invalid_argument("Unterminated string in JSON");
+    pos++; //Closing "
+    return result;
+}
+
+void JsonValue::escapeString(const std::string &s, std::string &out) {
+    out += '"';
+    for (char c: s) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * Serializes this value as compact, single-line JSON
+ * Time Complexity: O(n), n being the size of the serialized value
+ * @return String with the serialized value
+ */
+std::string JsonValue::dump() const {
+    std::string out;
+    dumpTo(out);
+    return out;
+}
+
+void JsonValue::dumpTo(std::string &out) const {
+    switch (type) {
+        case Type::NUL:
+            out += "null";
+            break;
+        case Type::BOOLEAN:
+            out += boolean ? "true" : "false";
+            break;
+        case Type::NUMBER: {
+            char buffer[32];
+            if (std::isfinite(number) && number == std::floor(number) && std::fabs(number) < 1e15)
+                snprintf(buffer, sizeof(buffer), "%.0f", number);
+            else if (std::isfinite(number)) snprintf(buffer, sizeof(buffer), "%.10g", number);
+            else snprintf(buffer, sizeof(buffer), "null");
+            out += buffer;
+            break;
+        }
+        case Type::STRING:
+            escapeString(string, out);
+            break;
+        case Type::ARRAY: {
+            out += '[';
+            for (size_t i = 0; i < elements.size(); i++) {
+                if (i > 0) out += ',';
+                elements[i].dumpTo(out);
+            }
+            out += ']';
+            break;
+        }
+        case Type::OBJECT: {
+            out += '{';
+            for (size_t i = 0; i < members.size(); i++) {
+                if (i > 0) out += ',';
+                escapeString(members[i].first, out);
+                out += ':';
+                members[i].second.dumpTo(out);
+            }
+            out += '}';
+            break;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_JSONVALUE_H
+#define RAILWAYMANAGEMENT_JSONVALUE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+class JsonValue {
+  public:
+    enum class Type {
+        NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT
+    };
+
+    JsonValue();
+
+    JsonValue(bool boolean);
+
+    JsonValue(double number);
+
+    JsonValue(unsigned int number);
+
+    JsonValue(int number);
+
+    JsonValue(unsigned long long number);
+
+    JsonValue(long long number);
+
+    JsonValue(const std::string &string);
+
+    JsonValue(const char *string);
+
+    static JsonValue array();
+
+    static JsonValue object();
+
+    static JsonValue parse(const std::string &text);
+
+    [[nodiscard]] Type getType() const;
+
+    [[nodiscard]] bool isNull() const;
+
+    [[nodiscard]] bool isNumber() const;
+
+    [[nodiscard]] bool isString() const;
+
+    [[nodiscard]] bool isArray() const;
+
+    [[nodiscard]] bool isObject() const;
+
+    [[nodiscard]] bool getBool() const;
+
+    [[nodiscard]] double getNumber() const;
+
+    [[nodiscard]] const std::string &getString() const;
+
+    [[nodiscard]] const std::vector<JsonValue> &getArray() const;
+
+    [[nodiscard]] const std::vector<std::pair<std::string, JsonValue>> &getMembers() const;
+
+    [[nodiscard]] bool has(const std::string &key) const;
+
+    [[nodiscard]] const JsonValue &at(const std::string &key) const;
+
+    void push(const JsonValue &value);
+
+    void set(const std::string &key, const JsonValue &value);
+
+    [[nodiscard]] std::string dump() const;
+
+  private:
+    Type type = Type::NUL;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JsonValue> elements;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    static JsonValue parseValue(const std::string &text, size_t &pos);
+
+    static std::string parseString(const std::string &text, size_t &pos);
+
+    static void skipWhitespace(const std::string &text, size_t &pos);
+
+    static void escapeString(const std::string &s, std::string &out);
+
+    void dumpTo(std::string &out) const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_JSONVALUE_H
@@ -1,7 +1,42 @@
+#include <csignal>
+#include <climits>
+#include <stdexcept>
+#include <thread>
 #include "menu.h"
 
-int main() {
+/**
+ * Parses the number of worker threads given to the server
+ * Time Complexity: O(size(text))
+ * @param text - Command line argument with the number
+ * @param numWorkers - Where the number is stored
+ * @return true if text is a whole number of at least 1 (that fits an unsigned int), false otherwise
+ */
+bool parseWorkers(const std::string &text, unsigned int &numWorkers) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    try {
+        unsigned long number = std::stoul(text);
+        if (number < 1 || number > UINT_MAX) return false;
+        numWorkers = (unsigned int) number;
+        return true;
+    } catch (const std::out_of_range &) {
+        return false;
+    }
+}
+
+int main(int argc, char *argv[]) {
     Menu menu;
+    if (argc >= 3 && std::string(argv[1]) == "--batch")
+        return menu.batchMode(argv[2], argc >= 4 ? argv[3] : "") ? 0 : 1;
+    if (argc >= 3 && std::string(argv[1]) == "--server") {
+        unsigned int numWorkers = std::max(1u, std::thread::hardware_concurrency());
+        if (argc >= 4 && !parseWorkers(argv[3], numWorkers)) {
+            std::cerr << "Usage: " << argv[0] << " --server <socket path> [number of workers, at least 1]" << std::endl;
+            return 1;
+        }
+        std::signal(SIGINT, [](int) { QueryServer::requestStop(); });
+        std::signal(SIGTERM, [](int) { QueryServer::requestStop(); });
+        return menu.serverMode(argv[2], numWorkers) ? 0 : 1;
+    }
     menu.minCostExample();
     return 0;
-}
\ No newline at end of file
+}
@@ -9,10 +9,17 @@ using namespace std;
 
 unsigned const Menu::COLUMN_WIDTH = 50;
 unsigned const Menu::COLUMNS_PER_LINE = 3;
+unsigned const Menu::SUGGESTION_DISTANCE = 3;
 string const Menu::stationsFilePath = "../dataset/stations.csv";
 string const Menu::networkFilePath = "../dataset/network.csv";
+string const Menu::costsFilePath = "../dataset/costs.csv";
 
-Menu::Menu() = default;
+/**
+ * Creates an empty menu, whose residual network shares the rail activation bitset of its network
+ */
+Menu::Menu() {
+    graph.shareRailActivation(residualGraph);
+}
 
 /**
  * Delegates initialization of the menu, calling the appropriate functions for information extraction and output
@@ -266,13 +273,60 @@ void Menu::incomingFlowExample() {
 }
 
 
+/**
+ * Runs every query in a query file against the network, without any user interaction, writing one JSON result per line
+ * Time Complexity: O(n*v) for loading the network, plus the sum of the complexities of the queries
+ * @param queryFilePath - Path of the file with one JSON query per line
+ * @param outputFilePath - Path of the file to write the results to, or an empty string to write them to the console
+ * @return True if the query and output files could be opened, false otherwise
+ */
+bool Menu::batchMode(const std::string &queryFilePath, const std::string &outputFilePath) {
+    ifstream queries(queryFilePath);
+    if (!queries) {
+        cerr << "Couldn't open the query file " << queryFilePath << "." << endl;
+        return false;
+    }
+
+    extractFileInfo();
+    QueryProcessor queryProcessor(graph, residualGraph, dataRepository, flowCache);
+    queryProcessor.setFluxWorkers(fluxWorkers);
+
+    if (outputFilePath.empty()) {
+        queryProcessor.processStream(queries, cout);
+        return true;
+    }
+
+    ofstream output(outputFilePath);
+    if (!output) {
+        cerr << "Couldn't open the output file " << outputFilePath << "." << endl;
+        return false;
+    }
+    queryProcessor.processStream(queries, output);
+    return true;
+}
+
+/**
+ * Loads the network once and answers queries sent through a Unix domain socket, until the process is interrupted
+ * Time Complexity: O(n*v) for loading the network, plus O(w(|V|+|E|)) for preparing the workers
+ * @param socketPath - Path of the socket to listen on
+ * @param numWorkers - Number of queries that can be executed at the same time
+ * @return True if the server ran and stopped normally, false if the socket couldn't be created
+ */
+bool Menu::serverMode(const std::string &socketPath, unsigned int numWorkers) {
+    extractFileInfo();
+    QueryServer queryServer(graph, dataRepository, numWorkers);
+    return queryServer.run(socketPath);
+}
+
 /**
  * Delegates extracting file info, calling the appropriate functions for each file
  * Time Complexity: O(n*v), where n is the number of lines of network.csv and v is the number of lines in stations.csv
  */
 void Menu::extractFileInfo() {
+    extractCostsFile();
     extractStationsFile();
     extractNetworkFile();
+    graph.applyCostModel(dataRepository.getServiceCosts());
 }
 
 /**
@@ -310,11 +364,19 @@ bool Menu::checkInput(unsigned int checkLength) {
 }
 
 /**
- * Outputs to the screen a message indicating that the given Station doesn't exist
- * Time Complexity: O(1)
+ * Outputs to the screen a message indicating that the given Station doesn't exist, suggesting the stations with the
+ * closest names (ignoring case and accents)
+ * Time Complexity: See DataRepository::findSimilarStations
+ * @param name - Name given for the Station
  */
-void Menu::stationDoesntExist() {
+void Menu::stationDoesntExist(const string &name) const {
     cout << "A station with this name doesn't exist!" << endl;
+    vector<Station> similar = dataRepository.findSimilarStations(name, SUGGESTION_DISTANCE, 3);
+    if (similar.empty()) similar = dataRepository.findStationsByPrefix(name, 3);
+    if (similar.empty()) return;
+    cout << "Did you mean: ";
+    for (size_t i = 0; i < similar.size(); i++) cout << (i == 0 ? "" : ", ") << similar[i].getName();
+    cout << "?" << endl;
 }
 
 /**
@@ -424,10 +486,7 @@ void Menu::extractStationsFile() {
                 if (counter == 0) {
                     if (!graph.addVertex(name)) break;
                     if (!residualGraph.addVertex(name)) break;
-                    Station newStation = dataRepository.addStationEntry(name, district, municipality, township, line);
-                    dataRepository.addStationToMunicipalityEntry(municipality, newStation);
-                    dataRepository.addStationToDistrictEntry(district, newStation);
-                    dataRepository.addStationToTownshipEntry(township, newStation);
+                    dataRepository.addStationEntry(name, district, municipality, township, line);
                 }
             }
         }
@@ -436,7 +495,8 @@ void Menu::extractStationsFile() {
 
 
 /**
- * Extracts and stores the information of flights.csv
+ * Extracts and stores the information of network.csv. Services are looked up in (or added to) the service cost model,
+ * and an optional fifth column gives the length of each rail in km
  * Time Complexity: 0(n*v), where n is the number of lines of network.csv and v is the number of nodes in graph
  */
 void Menu::extractNetworkFile() {
@@ -444,17 +504,14 @@ void Menu::extractNetworkFile() {
     ifstream network(networkFilePath);
 
     string currentParam, currentLine;
-    string sourceName, targetName;
-    Service service;
-    unsigned int capacity;
-
-    int counter = 0;
+    ServiceCostModel &serviceCosts = dataRepository.getServiceCosts();
 
     getline(network, currentParam); //Ignore first line with just descriptors
 
     while (getline(network, currentLine)) {
-        currentLine.erase(currentLine.end() - 1); //Remove \r
+        if (!currentLine.empty() && currentLine.back() == '\r') currentLine.pop_back(); //Remove \r
         istringstream iss(currentLine);
+        vector<string> fields;
         while (getline(iss, currentParam, ',')) {
             if (currentParam.find('"') != string::npos) { //If the line contains "
                 string leftover;
@@ -467,36 +524,40 @@ void Menu::extractNetworkFile() {
                     getline(iss, leftover, ','); //Remove trailing ,
                 }
             }
-            switch (counter++) {
-                case 0: {
-                    sourceName = currentParam;
-                    break;
-                }
-                case 1: {
-                    targetName = currentParam;
-                    break;
-                }
-                case 2: {
-                    capacity = stoul(currentParam);
-                    break;
-                }
-                case 3: {
-                    service = currentParam == "STANDARD" ? Service::STANDARD : Service::ALFA_PENDULAR;
-                    counter = 0;
-                    break;
-                }
-            }
-            if (counter == 0) {
-                auto [regular, regularReverse] = graph.addAndGetBidirectionalEdge(sourceName, targetName, capacity,
-                                                                                  service);
-                auto [residual, residualReverse] = residualGraph.addAndGetBidirectionalEdge(sourceName, targetName,
-                                                                                            capacity, service);
-                regular->setCorrespondingEdge(residual);
-                regularReverse->setCorrespondingEdge(residualReverse);
-                residual->setCorrespondingEdge(regular);
-                residualReverse->setCorrespondingEdge(regularReverse);
-            }
+            fields.push_back(currentParam);
         }
+        if (fields.size() < 4) continue;
+
+        const string &sourceName = fields[0];
+        const string &targetName = fields[1];
+        auto capacity = (Capacity) stoull(fields[2]);
+        Service service = serviceCosts.intern(fields[3]);
+        unsigned int length = fields.size() > 4 && !fields[4].empty() ? (unsigned int) stoul(fields[4]) : 0;
+        if (!serviceCosts.isPriced(service))
+            cerr << "The service " << fields[3] << " has no cost in " << costsFilePath << "." << endl;
+
+        auto [regular, regularReverse] = graph.addAndGetBidirectionalEdge(sourceName, targetName, capacity, service,
+                                                                          length);
+        auto [residual, residualReverse] = residualGraph.addAndGetBidirectionalEdge(sourceName, targetName, capacity,
+                                                                                    service, length);
+        regular->setCorrespondingEdge(residual);
+        regularReverse->setCorrespondingEdge(residualReverse);
+        residual->setCorrespondingEdge(regular);
+        residualReverse->setCorrespondingEdge(regularReverse);
+    }
+}
+
+/**
+ * Extracts the cost of each service from costs.csv, if it exists; the built-in costs are used otherwise
+ * Time Complexity: O(n) (average case), where n is the number of lines of costs.csv
+ */
+void Menu::extractCostsFile() {
+    ifstream costs(costsFilePath);
+    if (!costs) return;
+    try {
+        dataRepository.getServiceCosts().load(costs);
+    } catch (const invalid_argument &e) {
+        cerr << e.what() << " of " << costsFilePath << "." << endl;
     }
 }
 
@@ -537,7 +598,7 @@ unsigned int Menu::serviceMetricsMenu() {
                     if (!checkInput()) break;
                     optional<Station> departureStation = dataRepository.findStation(departureName);
                     if (!departureStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(departureName);
                         break;
                     }
 
@@ -547,10 +608,10 @@ unsigned int Menu::serviceMetricsMenu() {
                     if (!checkInput()) break;
                     optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
                     if (!arrivalStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(arrivalName);
                         break;
                     }
-                    cout << graph.edmondsKarp({departureName}, arrivalName, residualGraph)
+                    cout << flowCache.maxFlow(graph, {departureName}, arrivalName, residualGraph)
                          << " trains can simultaneously travel between "
                          << departureName
                          << " and " << arrivalName << "." << endl;
@@ -572,7 +633,7 @@ unsigned int Menu::serviceMetricsMenu() {
                     if (!checkInput()) break;
                     optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
                     if (!arrivalStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(arrivalName);
                         break;
                     }
                     cout
@@ -590,8 +651,9 @@ unsigned int Menu::serviceMetricsMenu() {
                              << " districts!" << endl;
                         break;
                     }
-                    std::vector<std::pair<std::string, double>> result = graph.topGroupings(
-                            dataRepository.getDistrictToStations(), residualGraph);
+                    std::unordered_map<std::string, Capacity> fluxCache;
+                    std::vector<std::pair<std::string, double>> result = graph.topKGroupings(
+                            dataRepository.getDistrictToStations(), residualGraph, fluxCache, numDistricts, fluxWorkers);
 
                     cout << endl << setw(COLUMN_WIDTH) << setfill(' ')
                          << "List of districts by average number of incoming trains capacity" << endl;
@@ -617,8 +679,9 @@ unsigned int Menu::serviceMetricsMenu() {
                              << " townships!" << endl;
                         break;
                     }
-                    std::vector<std::pair<std::string, double>> result = graph.topGroupings(
-                            dataRepository.getTownshipToStations(), residualGraph);
+                    std::unordered_map<std::string, Capacity> fluxCache;
+                    std::vector<std::pair<std::string, double>> result = graph.topKGroupings(
+                            dataRepository.getTownshipToStations(), residualGraph, fluxCache, numTownships, fluxWorkers);
 
                     cout << endl << setw(COLUMN_WIDTH) << setfill(' ')
                          << "List of townships by average number of incoming trains capacity" << endl;
@@ -644,8 +707,9 @@ unsigned int Menu::serviceMetricsMenu() {
                              << " municipalities!" << endl;
                         break;
                     }
-                    std::vector<std::pair<std::string, double>> result = graph.topGroupings(
-                            dataRepository.getMunicipalityToStations(), residualGraph);
+                    std::unordered_map<std::string, Capacity> fluxCache;
+                    std::vector<std::pair<std::string, double>> result = graph.topKGroupings(
+                            dataRepository.getMunicipalityToStations(), residualGraph, fluxCache, numMunicipalities, fluxWorkers);
 
                     cout << endl << setw(COLUMN_WIDTH) << setfill(' ')
                          << "List of municipalities by average number of incoming trains capacity" << endl;
@@ -710,7 +774,7 @@ unsigned int Menu::costOptMenu() {
                     if (!checkInput()) break;
                     optional<Station> departureStation = dataRepository.findStation(departureName);
                     if (!departureStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(departureName);
                         break;
                     }
 
@@ -720,11 +784,11 @@ unsigned int Menu::costOptMenu() {
                     if (!checkInput()) break;
                     optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
                     if (!arrivalStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(arrivalName);
                         break;
                     }
-                    pair<unsigned int, unsigned int> result = graph.minCostMaxFlow(departureName, arrivalName,
-                                                                                   residualGraph);
+                    pair<Capacity, Cost> result = flowCache.minCostMaxFlow(graph, departureName, arrivalName,
+                                                                           residualGraph);
 
                     cout << "Maintaining the network active at its maximum, " << result.first
                          << " trains can travel simultaneously between " << departureName << " and " << arrivalName
@@ -761,6 +825,7 @@ unsigned int Menu::failuresMenu() {
             cout << setw(COLUMN_WIDTH * COLUMNS_PER_LINE / 2) << left << "ILURES" << endl;
             cout << setw(COLUMN_WIDTH) << setfill(' ') << "Two specific stations: [1]" << setw(COLUMN_WIDTH)
                  << "Top affected stations: [2]" << endl;
+            cout << setw(COLUMN_WIDTH) << "Worst-case failures: [3]" << endl;
             cout << setw(COLUMN_WIDTH) << "Back: [b]" << setw(COLUMN_WIDTH) << "Quit: [q]" << endl;
         }
 
@@ -781,7 +846,7 @@ unsigned int Menu::failuresMenu() {
                     if (!checkInput()) break;
                     optional<Station> departureStation = dataRepository.findStation(departureName);
                     if (!departureStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(departureName);
                         break;
                     }
 
@@ -791,14 +856,14 @@ unsigned int Menu::failuresMenu() {
                     if (!checkInput()) break;
                     optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
                     if (!arrivalStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(arrivalName);
                         break;
                     }
 
                     vector<Edge *> deactivatedEdges = edgeFailureMenu();
                     if (deactivatedEdges.empty()) break;
 
-                    pair<unsigned int, unsigned int> result =
+                    pair<Capacity, Capacity> result =
                             graph.maxFlowDeactivatedEdges(deactivatedEdges, {departureName}, arrivalName,
                                                           residualGraph);
                     double reductionValue = result.first == 0 ? 0 : 100 - ((result.second * 1.0) / result.first) * 100;
@@ -822,8 +887,8 @@ unsigned int Menu::failuresMenu() {
                     vector<Edge *> deactivatedEdges = edgeFailureMenu();
                     if (deactivatedEdges.empty()) break;
 
-                    std::vector<std::pair<std::string, std::pair<unsigned int, unsigned int>>> result = graph.topReductions(
-                            deactivatedEdges, residualGraph);
+                    std::vector<std::pair<std::string, std::pair<Capacity, Capacity>>> result = graph.topKReductions(
+                            deactivatedEdges, residualGraph, numStations, fluxWorkers);
 
                     cout << setw(COLUMN_WIDTH) << setfill(' ')
                          << "List of stations by reduction number of incoming trains capacity" << endl << endl;
@@ -854,6 +919,55 @@ unsigned int Menu::failuresMenu() {
                     }
                     break;
                 }
+                case '3': {
+                    string departureName;
+                    cout << "Enter the name of the departure station: ";
+                    getline(cin, departureName);
+                    if (!checkInput()) break;
+                    optional<Station> departureStation = dataRepository.findStation(departureName);
+                    if (!departureStation.has_value()) {
+                        stationDoesntExist(departureName);
+                        break;
+                    }
+
+                    string arrivalName;
+                    cout << "Enter the name of the arrival station: ";
+                    getline(cin, arrivalName);
+                    if (!checkInput()) break;
+                    optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
+                    if (!arrivalStation.has_value()) {
+                        stationDoesntExist(arrivalName);
+                        break;
+                    }
+
+                    unsigned int k;
+                    cout << "Enter the maximum number of simultaneous rail failures (1 to 3): ";
+                    cin >> k;
+                    if (!checkInput()) break;
+                    if (k < 1 || k > 3) {
+                        cout << "Please choose between 1 and 3 failures." << endl;
+                        break;
+                    }
+
+                    FailureAnalysis analysis = graph.worstFailures(
+                            {graph.findVertex(departureName)->getIndex()}, graph.findVertex(arrivalName)->getIndex(),
+                            residualGraph, k, fluxWorkers);
+                    cout << "The maximum number of trains travelling between " << departureName << " and "
+                         << arrivalName << " is " << analysis.original << "." << endl;
+                    for (unsigned int i = 0; i < analysis.worst.size(); i++) {
+                        const FailureScenario &scenario = analysis.worst[i];
+                        double reductionValue = analysis.original == 0 ? 0 : 100 - ((scenario.flow * 1.0) /
+                                                                                    analysis.original) * 100;
+                        cout << "With up to " << i + 1 << " failed rail(s), it can drop to " << scenario.flow
+                             << ", in a " << fixed << setprecision(2) << reductionValue << "% reduction";
+                        if (scenario.rails.empty()) cout << " (no failure reduces it)";
+                        else cout << ", when these rails fail:";
+                        cout << endl;
+                        for (Edge const *rail: scenario.rails)
+                            cout << "    " << rail->getOrig()->getId() << " - " << rail->getDest()->getId() << endl;
+                    }
+                    break;
+                }
                 case 'b': {
                     return '\0';
                 }
@@ -923,7 +1037,7 @@ vector<Edge *> Menu::edgeFailureMenu() {
 
                     optional<Station> departureStation = dataRepository.findStation(departureName);
                     if (!departureStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(departureName);
                         break;
                     }
 
@@ -936,7 +1050,7 @@ vector<Edge *> Menu::edgeFailureMenu() {
 
                     optional<Station> arrivalStation = dataRepository.findStation(arrivalName);
                     if (!arrivalStation.has_value()) {
-                        stationDoesntExist();
+                        stationDoesntExist(arrivalName);
                         break;
                     }
 
@@ -14,18 +14,25 @@
 #include <sstream>
 #include <cmath>
 #include <unordered_set>
+#include <thread>
 #include "graph.h"
 #include "dataRepository.h"
+#include "queryProcessor.h"
+#include "queryServer.h"
 
 class Menu {
 private:
     DataRepository dataRepository;
     Graph residualGraph;
     Graph graph;
+    FlowCache flowCache;
+    unsigned int fluxWorkers = std::max(1u, std::thread::hardware_concurrency()); // threads for per-station flux reports
     std::string static const stationsFilePath;
     std::string static const networkFilePath;
+    std::string static const costsFilePath;
     unsigned static const COLUMN_WIDTH;
     unsigned static const COLUMNS_PER_LINE;
+    unsigned static const SUGGESTION_DISTANCE; // edit distance of the names suggested for unknown stations
 
 public:
     Menu();
@@ -34,6 +41,8 @@ public:
 
     void extractNetworkFile();
 
+    void extractCostsFile();
+
     void extractFileInfo();
 
     void initializeMenu();
@@ -46,11 +55,15 @@ public:
 
     void mainMenu();
 
+    bool batchMode(const std::string &queryFilePath, const std::string &outputFilePath);
+
+    bool serverMode(const std::string &socketPath, unsigned int numWorkers);
+
     std::vector<Edge *> edgeFailureMenu();
 
     static bool checkInput(unsigned int checkLength = 0);
 
-    static void stationDoesntExist();
+    void stationDoesntExist(const std::string &name) const;
 
     void edmondsKarpExample();
 
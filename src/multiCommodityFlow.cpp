@@ -0,0 +1,167 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "multiCommodityFlow.h"
+#include "graph.h"
+#include <cmath>
+
+/**
+ * Builds the flat arc array of the active rails of a network with positive capacity, grouped by origin vertex
+ * Time Complexity: O(|V|+|E|)
+ * @param graph - Network whose rails to copy
+ */
+MultiCommodityFlow::MultiCommodityFlow(const Graph &graph) : firstArc(graph.getNumVertex() + 1, 0) {
+    std::vector<Edge const *> rails;
+    for (unsigned int i = 0; i < graph.getTotalEdges(); i++) {
+        Edge const *rail = graph.getRail(i);
+        if (!graph.isRailActive(i) || rail->getCapacity() == 0) continue;
+        rails.push_back(rail);
+        firstArc[rail->getOrig()->getIndex() + 1]++;
+        firstArc[rail->getDest()->getIndex() + 1]++;
+    }
+    for (unsigned int v = 0; v < graph.getNumVertex(); v++) firstArc[v + 1] += firstArc[v];
+
+    std::vector<unsigned int> next(firstArc.begin(), firstArc.end() - 1);
+    arcHead.resize(2 * rails.size());
+    arcTail.resize(2 * rails.size());
+    arcRail.resize(2 * rails.size());
+    for (unsigned int r = 0; r < rails.size(); r++) {
+        unsigned int orig = rails[r]->getOrig()->getIndex(), dest = rails[r]->getDest()->getIndex();
+        for (auto [tail, head]: {std::make_pair(orig, dest), std::make_pair(dest, orig)}) {
+            unsigned int arc = next[tail]++;
+            arcTail[arc] = tail;
+            arcHead[arc] = head;
+            arcRail[arc] = r;
+        }
+        railCapacity.push_back((double) rails[r]->getCapacity());
+    }
+}
+
+unsigned int MultiCommodityFlow::getNumRails() const {
+    return (unsigned int) railCapacity.size();
+}
+
+/**
+ * Dijkstra's algorithm over the arc array, stopping when the target is settled
+ * Time Complexity: O((|V|+|E|) log(|V|))
+ * @param length - Length of each rail
+ * @param source - Index of the source Vertex
+ * @param target - Index of the target Vertex
+ * @param distance - Scratch vector of size |V|
+ * @param parentArc - Scratch vector of size |V|
+ * @param pathRails - Set to the rails of the shortest path, from the target back to the source
+ * @return True if the target can be reached, false if not
+ */
+bool MultiCommodityFlow::shortestPath(const std::vector<double> &length, unsigned int source, unsigned int target,
+                                      std::vector<double> &distance, std::vector<unsigned int> &parentArc,
+                                      std::vector<unsigned int> &pathRails) const {
+    FLOW_STATS_TIMER(pathSearchNs);
+    FLOW_STATS_ADD(pathSearches, 1);
+    const unsigned int NONE = std::numeric_limits<unsigned int>::max();
+    std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::infinity());
+    std::fill(parentArc.begin(), parentArc.end(), NONE);
+
+    using Entry = std::pair<double, unsigned int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    distance[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        if (d > distance[v]) continue;
+        if (v == target) break;
+        FLOW_STATS_ADD(verticesVisited, 1);
+        FLOW_STATS_ADD(edgesScanned, firstArc[v + 1] - firstArc[v]);
+        for (unsigned int arc = firstArc[v]; arc < firstArc[v + 1]; arc++) {
+            double candidate = d + length[arcRail[arc]];
+            if (candidate < distance[arcHead[arc]]) {
+                distance[arcHead[arc]] = candidate;
+                parentArc[arcHead[arc]] = arc;
+                queue.emplace(candidate, arcHead[arc]);
+            }
+        }
+    }
+    if (parentArc[target] == NONE) return false;
+
+    pathRails.clear();
+    for (unsigned int v = target; v != source; v = arcTail[parentArc[v]]) pathRails.push_back(arcRail[parentArc[v]]);
+    return true;
+}
+
+/**
+ * Approximates the max concurrent flow: the largest lambda such that lambda times every demand can be routed at the same
+ * time, and the flow of each commodity. The demands are first scaled so that the optimal lambda is between 1 and k
+ * (routing 1/k of each commodity's own max flow at the same time is always feasible), and doubled whenever the phases
+ * run longer than that range allows. The routed flow is finally scaled down until no rail is over its capacity
+ * Time Complexity: O(k log(k) ε⁻² log(|E|) (|V|+|E|) log(|V|)) (roughly), k being the number of commodities
+ * @param commodities - Origin-destination pairs and their demands
+ * @param soloFlows - Max flow of each commodity on its own; commodities with none (or no demand) get no flow and are left
+ * out of lambda
+ * @param epsilon - Approximation parameter (between 0 and 1): smaller is more precise but slower
+ * @return ConcurrentFlow with lambda and the flow of each commodity (at most its demand)
+ */
+ConcurrentFlow MultiCommodityFlow::solve(const std::vector<Commodity> &commodities, const std::vector<double> &soloFlows,
+                                         double epsilon) const {
+    ConcurrentFlow result;
+    result.commodities = commodities;
+    for (Commodity &commodity: result.commodities) commodity.flow = 0;
+
+    std::vector<unsigned int> routable;
+    for (unsigned int j = 0; j < commodities.size(); j++)
+        if (commodities[j].demand > 0 && soloFlows[j] > 0) routable.push_back(j);
+    if (routable.empty() || railCapacity.empty()) return result;
+
+    const auto k = (double) routable.size();
+    double scale = std::numeric_limits<double>::infinity();
+    for (unsigned int j: routable) scale = std::min(scale, soloFlows[j] / (k * commodities[j].demand));
+    std::vector<double> demand;
+    for (unsigned int j: routable) demand.push_back(commodities[j].demand * scale);
+
+    const auto m = (double) railCapacity.size();
+    const double delta = std::pow(m / (1 - epsilon), -1 / epsilon);
+    const auto maxPhases = (unsigned int) std::ceil(2 / epsilon * std::log(m / (1 - epsilon)) / std::log1p(epsilon));
+    std::vector<double> length(railCapacity.size()), load(railCapacity.size(), 0), routed(routable.size(), 0);
+    double volume = 0; // sum of length times capacity over every rail: the phases stop when it reaches 1
+    for (unsigned int r = 0; r < railCapacity.size(); r++) {
+        length[r] = delta / railCapacity[r];
+        volume += delta;
+    }
+
+    std::vector<double> distance(firstArc.size() - 1);
+    std::vector<unsigned int> parentArc(firstArc.size() - 1), pathRails;
+    for (unsigned int phase = 1; volume < 1; phase++) {
+        double previousVolume = volume;
+        for (unsigned int i = 0; i < routable.size() && volume < 1; i++) {
+            const Commodity &commodity = commodities[routable[i]];
+            double remaining = demand[i];
+            while (volume < 1 && remaining > 0 &&
+                   shortestPath(length, commodity.source, commodity.target, distance, parentArc, pathRails)) {
+                result.shortestPaths++;
+                double amount = remaining;
+                for (unsigned int r: pathRails) amount = std::min(amount, railCapacity[r]);
+                remaining -= amount;
+                routed[i] += amount;
+                for (unsigned int r: pathRails) {
+                    load[r] += amount;
+                    volume += length[r] * epsilon * amount;
+                    length[r] *= 1 + epsilon * amount / railCapacity[r];
+                }
+            }
+        }
+        if (volume == previousVolume) break; // nothing could be routed
+        // The optimal lambda is still large: doubling the demands halves it
+        if (phase % maxPhases == 0) for (double &d: demand) d *= 2;
+    }
+
+    double divisor = std::log(1 / delta) / std::log1p(epsilon);
+    for (unsigned int r = 0; r < railCapacity.size(); r++) divisor = std::max(divisor, load[r] / railCapacity[r]);
+    result.lambda = std::numeric_limits<double>::infinity();
+    for (unsigned int i = 0; i < routable.size(); i++) {
+        Commodity &commodity = result.commodities[routable[i]];
+        double flow = routed[i] / divisor;
+        result.lambda = std::min(result.lambda, flow / commodity.demand);
+        commodity.flow = std::min(flow, commodity.demand);
+    }
+    return result;
+}
@@ -0,0 +1,53 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_MULTICOMMODITYFLOW_H
+#define RAILWAYMANAGEMENT_MULTICOMMODITYFLOW_H
+
+#include <vector>
+
+class Graph;
+
+struct Commodity {
+    unsigned int source = 0;
+    unsigned int target = 0;
+    double demand = 0;
+    double flow = 0; // routed at the same time as every other commodity, at most the demand
+};
+
+struct ConcurrentFlow {
+    double lambda = 0; // fraction of every (routable) demand that can be routed at the same time; may exceed 1
+    std::vector<Commodity> commodities;
+    unsigned long long shortestPaths = 0; // shortest path searches done
+};
+
+/**
+ * Garg-Könemann approximation of the max concurrent multi-commodity flow over the active rails of a network, stored as a
+ * flat arc array (both directions of a rail are arcs sharing the rail's capacity, as trains going either way use the
+ * same track). Every commodity repeatedly routes its demand along its shortest path under lengths that grow
+ * exponentially with the load of each rail, so that congested rails are avoided
+ */
+class MultiCommodityFlow {
+  private:
+    std::vector<unsigned int> firstArc; // arcs leaving vertex v are firstArc[v] to firstArc[v + 1] - 1
+    std::vector<unsigned int> arcHead;
+    std::vector<unsigned int> arcTail;
+    std::vector<unsigned int> arcRail; // rail of each arc, numbered among the active rails
+    std::vector<double> railCapacity;
+
+    bool shortestPath(const std::vector<double> &length, unsigned int source, unsigned int target,
+                      std::vector<double> &distance, std::vector<unsigned int> &parentArc,
+                      std::vector<unsigned int> &pathRails) const;
+
+  public:
+    explicit MultiCommodityFlow(const Graph &graph);
+
+    [[nodiscard]] unsigned int getNumRails() const;
+
+    [[nodiscard]] ConcurrentFlow solve(const std::vector<Commodity> &commodities, const std::vector<double> &soloFlows,
+                                       double epsilon) const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_MULTICOMMODITYFLOW_H
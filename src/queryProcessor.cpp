@@ -0,0 +1,660 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include "queryProcessor.h"
+
+using namespace std;
+
+QueryProcessor::QueryProcessor(Graph &graph, Graph &residualGraph, DataRepository &dataRepository,
+                               FlowCache &flowCache)
+        : graph(graph), residualGraph(residualGraph), dataRepository(dataRepository), flowCache(flowCache) {}
+
+void QueryProcessor::setFluxWorkers(unsigned int numWorkers) {
+    fluxWorkers = numWorkers;
+}
+
+/**
+ * Reads a station name from a query field, checking that the station exists
+ * Time Complexity: O(1) (average case) | O(|V|) (worst case)
+ * @param query - Query object
+ * @param key - Name of the field holding the station name
+ * @return Name of the station; throws std::invalid_argument if missing or unknown
+ */
+string QueryProcessor::requireStation(const JsonValue &query, const string &key) {
+    const string &name = query.at(key).getString();
+    if (!dataRepository.findStation(name).has_value()) unknownStation(name);
+    return name;
+}
+
+/**
+ * Reports an unknown station name, suggesting the station with the closest name (ignoring case and accents) if any is
+ * close enough
+ * Time Complexity: See DataRepository::findSimilarStations
+ * @param name - Name given for the station
+ */
+void QueryProcessor::unknownStation(const string &name) {
+    string message = "A station named \"" + name + "\" doesn't exist";
+    vector<Station> similar = dataRepository.findSimilarStations(name, 3, 1);
+    if (!similar.empty()) message += " (did you mean \"" + similar[0].getName() + "\"?)";
+    throw invalid_argument(message);
+}
+
+/**
+ * Reads the source station(s) of a query, given either as a single name or as an array of names
+ * Time Complexity: O(s), s being the number of sources (average case)
+ * @param query - Query object
+ * @return List of source station names
+ */
+list<string> QueryProcessor::requireSources(const JsonValue &query) {
+    const JsonValue &source = query.at("source");
+    if (!source.isArray()) return {requireStation(query, "source")};
+
+    list<string> sources;
+    for (const JsonValue &name: source.getArray()) {
+        if (!dataRepository.findStation(name.getString()).has_value()) unknownStation(name.getString());
+        sources.push_back(name.getString());
+    }
+    if (sources.empty()) throw invalid_argument("At least one source station is required");
+    return sources;
+}
+
+/**
+ * Reads the max flow algorithm a query asks for, given as "engine" ("edmonds_karp" by default, "capacity_scaling" or
+ * "boykov_kolmogorov")
+ * Time Complexity: O(1)
+ * @param query - Query object
+ * @return The chosen engine; throws std::invalid_argument if unknown
+ */
+MaxFlowEngine QueryProcessor::optionalEngine(const JsonValue &query) {
+    if (!query.has("engine")) return MaxFlowEngine::EDMONDS_KARP;
+    const string &engine = query.at("engine").getString();
+    if (engine == "edmonds_karp") return MaxFlowEngine::EDMONDS_KARP;
+    if (engine == "capacity_scaling") return MaxFlowEngine::CAPACITY_SCALING;
+    if (engine == "boykov_kolmogorov") return MaxFlowEngine::BOYKOV_KOLMOGOROV;
+    throw invalid_argument("Unknown max flow engine \"" + engine + "\"");
+}
+
+/**
+ * Reads the augmenting path search strategy a query asks for, given as "search" ("bfs" by default, or "bidirectional")
+ * Time Complexity: O(1)
+ * @param query - Query object
+ * @return The chosen strategy; throws std::invalid_argument if unknown
+ */
+PathSearch QueryProcessor::optionalSearch(const JsonValue &query) {
+    if (!query.has("search")) return PathSearch::BFS;
+    const string &search = query.at("search").getString();
+    if (search == "bfs") return PathSearch::BFS;
+    if (search == "bidirectional") return PathSearch::BIDIRECTIONAL;
+    throw invalid_argument("Unknown path search \"" + search + "\"");
+}
+
+/**
+ * Finds the rail given as a [station, station] pair
+ * Time Complexity: O(d), d being the degree of the first station
+ * @param rail - Pair of station names
+ * @return Pointer to the Edge from the first station to the second; throws std::invalid_argument if there is none
+ */
+Edge *QueryProcessor::requireRail(const JsonValue &rail) {
+    const vector<JsonValue> &ends = rail.getArray();
+    if (ends.size() != 2) throw invalid_argument("Each rail must be given as a pair of stations");
+    const string &departureName = ends[0].getString();
+    const string &arrivalName = ends[1].getString();
+
+    Vertex *departureVertex = graph.findVertex(departureName);
+    if (departureVertex == nullptr)
+        throw invalid_argument("A station named \"" + departureName + "\" doesn't exist");
+
+    const vector<Edge *> &adjacentEdges = departureVertex->getAdj();
+    auto currentEdge = find_if(adjacentEdges.begin(), adjacentEdges.end(), [&arrivalName](Edge *e) {
+        return e->getDest()->getId() == arrivalName;
+    });
+    if (currentEdge == adjacentEdges.end())
+        throw invalid_argument(departureName + " and " + arrivalName + " are not directly connected");
+    return *currentEdge;
+}
+
+/**
+ * Reads the rails to deactivate in a failure query, given either as "rails" (array of [station, station] pairs)
+ * or as "random_rails" (number of rails to pick at random)
+ * Time Complexity: O(r*d), r being the number of rails and d the max degree of a station
+ * @param query - Query object
+ * @return Vector of pointers to the Edges to deactivate
+ */
+vector<Edge *> QueryProcessor::requireRails(const JsonValue &query) {
+    vector<Edge *> rails;
+
+    if (query.has("random_rails")) {
+        auto numEdges = (unsigned int) requireWhole(query.at("random_rails"), "random_rails", UINT_MAX);
+        if (numEdges > graph.getTotalEdges())
+            throw invalid_argument("The network only contains " + to_string(graph.getTotalEdges()) + " rails");
+        return graph.randomlySelectEdges(numEdges);
+    }
+
+    for (const JsonValue &rail: query.at("rails").getArray()) rails.push_back(requireRail(rail));
+    if (rails.empty()) throw invalid_argument("At least one rail must be deactivated");
+    return rails;
+}
+
+/**
+ * Reads the sources or sinks of a multi-terminal query, each given either as a station name (unbounded) or as an object
+ * with the "station" and its cap, under capKey ("supply" or "demand")
+ * Time Complexity: O(t), t being the number of terminals (average case)
+ * @param query - Query object
+ * @param key - Name of the field holding the terminals
+ * @param capKey - Name of the field holding each terminal's cap
+ * @return Vector of TerminalFlow with the index of each station and its cap (INFINITE_CAPACITY if not given)
+ */
+vector<TerminalFlow> QueryProcessor::requireTerminals(const JsonValue &query, const string &key,
+                                                      const string &capKey) {
+    vector<TerminalFlow> terminals;
+    for (const JsonValue &terminal: query.at(key).getArray()) {
+        const JsonValue &station = terminal.isObject() ? terminal.at("station") : terminal;
+        Vertex const *vertex = graph.findVertex(station.getString());
+        if (vertex == nullptr) unknownStation(station.getString());
+
+        Capacity capacity = INFINITE_CAPACITY;
+        if (terminal.isObject() && terminal.has(capKey))
+            capacity = (Capacity) requireWhole(terminal.at(capKey), capKey, INFINITE_CAPACITY);
+        terminals.push_back({vertex->getIndex(), capacity, 0});
+    }
+    if (terminals.empty()) throw invalid_argument("At least one station is required in \"" + key + "\"");
+    return terminals;
+}
+
+/**
+ * Reads a whole, non-negative number from a query field, which a plain cast from double would turn into garbage (or
+ * undefined behaviour) when negative, fractional or too large
+ * Time Complexity: O(1)
+ * @param value - Value of the field
+ * @param key - Name of the field, for the error message
+ * @param max - Largest value accepted
+ * @return The number; throws std::invalid_argument if it isn't a whole number between 0 and max
+ */
+unsigned long long QueryProcessor::requireWhole(const JsonValue &value, const string &key, unsigned long long max) {
+    double number = value.getNumber();
+    if (!(number >= 0) || number != floor(number) || number >= (double) max + 1)
+        throw invalid_argument("\"" + key + "\" must be a whole number between 0 and " + to_string(max));
+    return (unsigned long long) number;
+}
+
+unsigned int QueryProcessor::optionalCount(const JsonValue &query, unsigned int defaultCount) {
+    if (!query.has("count")) return defaultCount;
+    return (unsigned int) min((unsigned long long) defaultCount, requireWhole(query.at("count"), "count", UINT_MAX));
+}
+
+JsonValue QueryProcessor::maxFlowQuery(const JsonValue &query) {
+    list<string> sources = requireSources(query);
+    string target = requireStation(query, "target");
+
+    JsonValue result = JsonValue::object();
+    if (!query.has("paths") || !query.at("paths").getBool()) {
+        result.set("flow", flowCache.maxFlow(graph, sources, target, residualGraph, optionalEngine(query),
+                                             optionalSearch(query)));
+        return result;
+    }
+
+    // The routes need the flow itself, which the cache doesn't keep
+    FlowDecomposition decomposition = graph.maxFlowDecomposition(sources, target, residualGraph,
+                                                                 optionalEngine(query), optionalSearch(query));
+    JsonValue paths = JsonValue::array();
+    for (const FlowPath &path: decomposition.paths) {
+        JsonValue stations = JsonValue::array();
+        stations.push(path.edges.front()->getOrig()->getId());
+        for (Edge const *e: path.edges) stations.push(e->getDest()->getId());
+        JsonValue entry = JsonValue::object();
+        entry.set("stations", stations);
+        entry.set("trains", path.trains);
+        paths.push(entry);
+    }
+    result.set("flow", decomposition.value);
+    result.set("paths", paths);
+    return result;
+}
+
+JsonValue QueryProcessor::incomingFluxQuery(const JsonValue &query) {
+    string station = requireStation(query, "station");
+
+    auto it = incomingFluxCache.find(station);
+    if (it == incomingFluxCache.end())
+        it = incomingFluxCache.emplace(station, graph.incomingFlux(station, residualGraph)).first;
+
+    JsonValue result = JsonValue::object();
+    result.set("flux", it->second);
+    return result;
+}
+
+JsonValue QueryProcessor::networkMaxFlowQuery() {
+    pair<list<pair<string, string>>, Capacity> networkMaxFlow = graph.calculateNetworkMaxFlow(residualGraph);
+
+    JsonValue pairs = JsonValue::array();
+    for (const pair<string, string> &p: networkMaxFlow.first) {
+        JsonValue stationPair = JsonValue::array();
+        stationPair.push(p.first);
+        stationPair.push(p.second);
+        pairs.push(stationPair);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("flow", networkMaxFlow.second);
+    result.set("pairs", pairs);
+    return result;
+}
+
+JsonValue QueryProcessor::topGroupingsQuery(const JsonValue &query, const StationGrouping &group) {
+    unsigned int count = optionalCount(query, (unsigned int) group.size());
+    vector<pair<string, double>> groupings = graph.topKGroupings(group, residualGraph, incomingFluxCache, count,
+                                                                 fluxWorkers);
+
+    JsonValue ranking = JsonValue::array();
+    for (unsigned int i = 0; i < groupings.size(); i++) {
+        JsonValue entry = JsonValue::object();
+        entry.set("name", groupings[i].first);
+        entry.set("average", groupings[i].second);
+        ranking.push(entry);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("ranking", ranking);
+    return result;
+}
+
+/**
+ * Reads the tariff of a min cost query: the loaded service costs, with the services listed in the optional "costs"
+ * object replaced. Each service maps either to its cost per train or to an object with "cost" and/or "per_km"
+ * Time Complexity: O(s) (average case), s being the number of services listed
+ * @param query - Query object
+ * @return Service costs to use; throws std::invalid_argument if a service is unknown or a cost is invalid
+ */
+ServiceCostModel QueryProcessor::optionalCosts(const JsonValue &query) const {
+    ServiceCostModel costs = dataRepository.getServiceCosts();
+    if (!query.has("costs")) return costs;
+    for (const auto &[name, tariff]: query.at("costs").getMembers()) {
+        optional<Service> service = costs.find(name);
+        if (!service.has_value()) throw invalid_argument("A service named \"" + name + "\" doesn't exist");
+        Cost trainCost = costs.getTrainCost(*service);
+        double kmCost = costs.getKmCost(*service);
+        if (tariff.isNumber()) {
+            trainCost = (Cost) requireWhole(tariff, name, INFINITE_COST);
+        } else {
+            if (tariff.has("cost")) trainCost = (Cost) requireWhole(tariff.at("cost"), "cost", INFINITE_COST);
+            if (tariff.has("per_km")) kmCost = tariff.at("per_km").getNumber();
+        }
+        costs.setCost(*service, trainCost, kmCost);
+    }
+    return costs;
+}
+
+JsonValue QueryProcessor::minCostQuery(const JsonValue &query) {
+    string source = requireStation(query, "source");
+    string target = requireStation(query, "target");
+    pair<Capacity, Cost> minCost;
+    if (query.has("costs")) {
+        // Puts the loaded tariff back even if the query throws
+        struct TariffGuard {
+            Graph &graph;
+            const ServiceCostModel &costs;
+
+            ~TariffGuard() { graph.applyCostModel(costs); }
+        };
+        ServiceCostModel costs = optionalCosts(query);
+        TariffGuard guard{graph, dataRepository.getServiceCosts()};
+        graph.applyCostModel(costs);
+        minCost = flowCache.minCostMaxFlow(graph, source, target, residualGraph);
+    } else {
+        minCost = flowCache.minCostMaxFlow(graph, source, target, residualGraph);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("flow", minCost.first);
+    result.set("cost", minCost.second);
+    return result;
+}
+
+JsonValue QueryProcessor::failureQuery(const JsonValue &query) {
+    list<string> sources = requireSources(query);
+    string target = requireStation(query, "target");
+    vector<Edge *> rails = requireRails(query);
+    pair<Capacity, Capacity> flows = graph.maxFlowDeactivatedEdges(rails, sources, target, residualGraph,
+                                                                            optionalEngine(query),
+                                                                            optionalSearch(query));
+
+    JsonValue result = JsonValue::object();
+    result.set("original", flows.first);
+    result.set("reduced", flows.second);
+    result.set("reduction", reductionPercentage(flows.first, flows.second));
+    return result;
+}
+
+JsonValue QueryProcessor::topReductionsQuery(const JsonValue &query) {
+    vector<Edge *> rails = requireRails(query);
+    unsigned int count = optionalCount(query, graph.getNumVertex());
+    vector<pair<string, pair<Capacity, Capacity>>> reductions = graph.topKReductions(rails, residualGraph, count,
+                                                                                            fluxWorkers);
+
+    JsonValue ranking = JsonValue::array();
+    for (unsigned int i = 0; i < reductions.size(); i++) {
+        JsonValue entry = JsonValue::object();
+        entry.set("station", reductions[i].first);
+        entry.set("original", reductions[i].second.first);
+        entry.set("reduced", reductions[i].second.second);
+        entry.set("reduction", reductionPercentage(reductions[i].second.first, reductions[i].second.second));
+        ranking.push(entry);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("ranking", ranking);
+    return result;
+}
+
+JsonValue QueryProcessor::contingencyQuery(const JsonValue &query) {
+    vector<unsigned int> sources;
+    unsigned int target;
+    if (query.has("station")) {
+        // Incoming flux of a station, as in incomingFluxQuery
+        target = graph.findVertex(requireStation(query, "station"))->getIndex();
+        sources = graph.getEndOfLines(graph.getComponent(target));
+    } else {
+        for (const string &s: requireSources(query)) sources.push_back(graph.findVertex(s)->getIndex());
+        target = graph.findVertex(requireStation(query, "target"))->getIndex();
+    }
+    auto k = (unsigned int) (query.has("k") ? requireWhole(query.at("k"), "k", 3) : 1);
+    if (k < 1 || k > 3) throw invalid_argument("The number of failed rails k must be between 1 and 3");
+
+    FailureAnalysis analysis = graph.worstFailures(sources, target, residualGraph, k, fluxWorkers);
+
+    JsonValue worst = JsonValue::array();
+    for (unsigned int i = 0; i < analysis.worst.size(); i++) {
+        JsonValue rails = JsonValue::array();
+        for (Edge const *rail: analysis.worst[i].rails) {
+            JsonValue ends = JsonValue::array();
+            ends.push(rail->getOrig()->getId());
+            ends.push(rail->getDest()->getId());
+            rails.push(ends);
+        }
+        JsonValue entry = JsonValue::object();
+        entry.set("k", i + 1);
+        entry.set("rails", rails);
+        entry.set("flow", analysis.worst[i].flow);
+        entry.set("reduction", reductionPercentage(analysis.original, analysis.worst[i].flow));
+        worst.push(entry);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("original", analysis.original);
+    result.set("worst", worst);
+    result.set("evaluated", (double) analysis.evaluated);
+    return result;
+}
+
+JsonValue QueryProcessor::scenariosQuery(const JsonValue &query) {
+    vector<unsigned int> sources;
+    for (const string &s: requireSources(query)) sources.push_back(graph.findVertex(s)->getIndex());
+    unsigned int target = graph.findVertex(requireStation(query, "target"))->getIndex();
+
+    // The first scenario is the unchanged network, to measure the reductions against
+    vector<Scenario> scenarios(1, Scenario(graph.getTotalEdges()));
+    vector<string> names;
+    for (const JsonValue &description: query.at("scenarios").getArray()) {
+        Scenario scenario(graph.getTotalEdges());
+        if (description.has("rails") || description.has("random_rails"))
+            for (Edge const *rail: requireRails(description)) scenario.fail(rail->getIndex());
+        if (description.has("capacities")) {
+            for (const JsonValue &change: description.at("capacities").getArray()) {
+                auto capacity = (Capacity) requireWhole(change.at("capacity"), "capacity", INFINITE_CAPACITY);
+                scenario.setCapacity(requireRail(change.at("rail"))->getIndex(), capacity);
+            }
+        }
+        names.push_back(description.has("name") ? description.at("name").getString()
+                                                : "scenario " + to_string(names.size() + 1));
+        scenarios.push_back(scenario);
+    }
+
+    vector<Capacity> flows = graph.scenarioMaxFlows(scenarios, sources, target, fluxWorkers);
+
+    JsonValue results = JsonValue::array();
+    for (unsigned int i = 0; i < names.size(); i++) {
+        JsonValue entry = JsonValue::object();
+        entry.set("name", names[i]);
+        entry.set("flow", flows[i + 1]);
+        entry.set("reduction", reductionPercentage(flows[0], flows[i + 1]));
+        results.push(entry);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("original", flows[0]);
+    result.set("scenarios", results);
+    return result;
+}
+
+JsonValue QueryProcessor::multiFlowQuery(const JsonValue &query) {
+    vector<TerminalFlow> sources = requireTerminals(query, "sources", "supply");
+    vector<TerminalFlow> sinks = requireTerminals(query, "sinks", "demand");
+    MultiTerminalFlow flow = graph.multiTerminalMaxFlow(sources, sinks, residualGraph, optionalEngine(query));
+
+    vector<Vertex *> vertices = graph.getVertexSet();
+    auto describe = [&](const vector<TerminalFlow> &terminals, const string &capKey) {
+        JsonValue entries = JsonValue::array();
+        for (const TerminalFlow &terminal: terminals) {
+            JsonValue entry = JsonValue::object();
+            entry.set("station", vertices[terminal.vertex]->getId());
+            if (terminal.capacity != INFINITE_CAPACITY) entry.set(capKey, terminal.capacity);
+            entry.set("flow", terminal.flow);
+            entries.push(entry);
+        }
+        return entries;
+    };
+
+    JsonValue result = JsonValue::object();
+    result.set("flow", flow.value);
+    result.set("sources", describe(flow.sources, "supply"));
+    result.set("sinks", describe(flow.sinks, "demand"));
+    return result;
+}
+
+JsonValue QueryProcessor::multiCommodityQuery(const JsonValue &query) {
+    vector<Commodity> commodities;
+    for (const JsonValue &pair: query.at("demands").getArray()) {
+        Commodity commodity;
+        commodity.source = graph.findVertex(requireStation(pair, "source"))->getIndex();
+        commodity.target = graph.findVertex(requireStation(pair, "target"))->getIndex();
+        commodity.demand = pair.at("demand").getNumber();
+        if (commodity.source == commodity.target) throw invalid_argument("The source and target of a demand must differ");
+        if (commodity.demand <= 0) throw invalid_argument("Demands must be positive");
+        commodities.push_back(commodity);
+    }
+    if (commodities.empty()) throw invalid_argument("At least one demand is required");
+    double epsilon = query.has("epsilon") ? query.at("epsilon").getNumber() : 0.1;
+    if (epsilon <= 0 || epsilon > 0.5) throw invalid_argument("epsilon must be greater than 0 and at most 0.5");
+
+    ConcurrentFlow flow = graph.maxConcurrentFlow(commodities, residualGraph, epsilon);
+    vector<Vertex *> vertices = graph.getVertexSet();
+    JsonValue pairs = JsonValue::array();
+    for (const Commodity &commodity: flow.commodities) {
+        JsonValue entry = JsonValue::object();
+        entry.set("source", vertices[commodity.source]->getId());
+        entry.set("target", vertices[commodity.target]->getId());
+        entry.set("demand", commodity.demand);
+        entry.set("flow", commodity.flow);
+        pairs.push(entry);
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("lambda", flow.lambda);
+    result.set("pairs", pairs);
+    return result;
+}
+
+JsonValue QueryProcessor::regionReportQuery(const JsonValue &query) {
+    static const vector<pair<string, RegionLevel>> levels = {{"district",     RegionLevel::DISTRICT},
+                                                             {"municipality", RegionLevel::MUNICIPALITY},
+                                                             {"township",     RegionLevel::TOWNSHIP}};
+    const RegionHierarchy &hierarchy = dataRepository.getRegionHierarchy();
+    RegionRollup rollup = hierarchy.rollUp(
+            graph.stationFluxes(dataRepository.getStations(), residualGraph, incomingFluxCache, fluxWorkers));
+
+    JsonValue ranking = JsonValue::array();
+    if (!query.has("regions")) {
+        const string &levelName = query.at("level").getString();
+        auto level = find_if(levels.begin(), levels.end(), [&levelName](const auto &l) { return l.first == levelName; });
+        if (level == levels.end()) throw invalid_argument("Unknown region level \"" + levelName + "\"");
+
+        vector<pair<string, double>> regions = rollup.ranking(level->second);
+        unsigned int count = optionalCount(query, (unsigned int) regions.size());
+        for (unsigned int i = 0; i < count; i++) {
+            JsonValue entry = JsonValue::object();
+            entry.set("name", regions[i].first);
+            entry.set("average", regions[i].second);
+            ranking.push(entry);
+        }
+    } else {
+        const Dictionary *dictionaries[] = {&dataRepository.getDistricts(), &dataRepository.getMunicipalities(),
+                                            &dataRepository.getTownships()};
+        for (const JsonValue &region: query.at("regions").getArray()) {
+            vector<pair<RegionLevel, unsigned int>> parts;
+            for (const auto &[levelName, level]: levels) {
+                if (!region.has(levelName)) continue;
+                for (const JsonValue &name: region.at(levelName).getArray()) {
+                    optional<unsigned int> id = dictionaries[(unsigned int) level]->find(name.getString());
+                    if (!id.has_value())
+                        throw invalid_argument("A " + levelName + " named \"" + name.getString() + "\" doesn't exist");
+                    parts.emplace_back(level, id.value());
+                }
+            }
+            RegionTotals totals = rollup.combine(parts);
+            JsonValue entry = JsonValue::object();
+            entry.set("name", region.at("name").getString());
+            entry.set("average", totals.average());
+            entry.set("stations", totals.count);
+            ranking.push(entry);
+        }
+    }
+
+    JsonValue result = JsonValue::object();
+    result.set("ranking", ranking);
+    return result;
+}
+
+JsonValue QueryProcessor::stationSearchQuery(const JsonValue &query) {
+    auto count = (unsigned int) (query.has("count") ? requireWhole(query.at("count"), "count", UINT_MAX) : 10);
+    vector<Station> stations;
+    if (query.has("prefix")) {
+        stations = dataRepository.findStationsByPrefix(query.at("prefix").getString(), count);
+    } else {
+        unsigned int distance = 2;
+        if (query.has("distance")) distance = (unsigned int) requireWhole(query.at("distance"), "distance", UINT_MAX);
+        stations = dataRepository.findSimilarStations(query.at("name").getString(), distance, count);
+    }
+
+    JsonValue names = JsonValue::array();
+    for (const Station &s: stations) names.push(s.getName());
+    JsonValue result = JsonValue::object();
+    result.set("stations", names);
+    return result;
+}
+
+JsonValue QueryProcessor::cacheStatsQuery() const {
+    JsonValue result = JsonValue::object();
+    result.set("hits", (double) flowCache.getHits());
+    result.set("misses", (double) flowCache.getMisses());
+    result.set("size", (double) flowCache.getSize());
+    return result;
+}
+
+/**
+ * Executes a single query against the loaded network
+ * Time Complexity: That of the underlying Graph function
+ * @param query - Query object, identified by its "query" field
+ * @return Result object with the query's "id" (if given), its "status" and either its "result" or an error "message".
+ * When built with RAILWAY_FLOW_STATS, it also holds the query's flow algorithm "stats"
+ */
+JsonValue QueryProcessor::processQuery(const JsonValue &query) {
+    JsonValue response = JsonValue::object();
+    if (query.has("id")) response.set("id", query.at("id"));
+
+    flowStatistics.reset();
+    auto start = chrono::steady_clock::now();
+    try {
+        const string &type = query.at("query").getString();
+        response.set("query", type);
+
+        JsonValue result;
+        if (type == "maxflow") result = maxFlowQuery(query);
+        else if (type == "flux") result = incomingFluxQuery(query);
+        else if (type == "network_maxflow") result = networkMaxFlowQuery();
+        else if (type == "top_districts") result = topGroupingsQuery(query, dataRepository.getDistrictToStations());
+        else if (type == "top_municipalities")
+            result = topGroupingsQuery(query, dataRepository.getMunicipalityToStations());
+        else if (type == "top_townships") result = topGroupingsQuery(query, dataRepository.getTownshipToStations());
+        else if (type == "mincost") result = minCostQuery(query);
+        else if (type == "failure") result = failureQuery(query);
+        else if (type == "top_reductions") result = topReductionsQuery(query);
+        else if (type == "contingency") result = contingencyQuery(query);
+        else if (type == "scenarios") result = scenariosQuery(query);
+        else if (type == "multiflow") result = multiFlowQuery(query);
+        else if (type == "multicommodity") result = multiCommodityQuery(query);
+        else if (type == "region_report") result = regionReportQuery(query);
+        else if (type == "stations") result = stationSearchQuery(query);
+        else if (type == "cache_stats") result = cacheStatsQuery();
+        else throw invalid_argument("Unknown query type \"" + type + "\"");
+
+        response.set("status", "ok");
+        response.set("result", result);
+    } catch (const exception &e) {
+        response.set("status", "error");
+        response.set("message", e.what());
+    }
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    response.set("time_ms", elapsed.count());
+
+    if (FlowStatistics::enabled()) {
+        JsonValue stats = JsonValue::object();
+        for (const auto &[name, value]: flowStatistics.entries()) stats.set(name, value);
+        response.set("stats", stats);
+    }
+    return response;
+}
+
+/**
+ * Parses and executes a single query line
+ * Time Complexity: That of the underlying Graph function
+ * @param line - Query serialized as a JSON object
+ * @return Result serialized as a single-line JSON object
+ */
+string QueryProcessor::processLine(const string &line) {
+    JsonValue query;
+    try {
+        query = JsonValue::parse(line);
+    } catch (const exception &e) {
+        JsonValue response = JsonValue::object();
+        response.set("status", "error");
+        response.set("message", string("Malformed query: ") + e.what());
+        return response.dump();
+    }
+    return processQuery(query).dump();
+}
+
+/**
+ * Executes every query of a stream, one JSON object per line, writing one JSON result per line. Blank lines and lines
+ * starting with # are ignored
+ * Time Complexity: Sum of the complexities of the executed queries
+ * @param in - Stream to read the queries from
+ * @param out - Stream to write the results to
+ * @return Number of queries executed
+ */
+unsigned int QueryProcessor::processStream(istream &in, ostream &out) {
+    unsigned int processed = 0;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == string::npos || line[first] == '#') continue;
+        out << processLine(line) << '\n';
+        processed++;
+    }
+    out.flush();
+    return processed;
+}
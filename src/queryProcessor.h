@@ -0,0 +1,91 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_QUERYPROCESSOR_H
+#define RAILWAYMANAGEMENT_QUERYPROCESSOR_H
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "graph.h"
+#include "dataRepository.h"
+#include "jsonValue.h"
+#include "flowCache.h"
+
+class QueryProcessor {
+  private:
+    Graph &graph;
+    Graph &residualGraph;
+    DataRepository &dataRepository;
+    FlowCache &flowCache;
+    std::unordered_map<std::string, Capacity> incomingFluxCache;
+    unsigned int fluxWorkers = 1; // threads used by the per-station flux reports
+
+    std::string requireStation(const JsonValue &query, const std::string &key);
+
+    [[noreturn]] void unknownStation(const std::string &name);
+
+    std::list<std::string> requireSources(const JsonValue &query);
+
+    Edge *requireRail(const JsonValue &rail);
+
+    std::vector<Edge *> requireRails(const JsonValue &query);
+
+    std::vector<TerminalFlow> requireTerminals(const JsonValue &query, const std::string &key,
+                                               const std::string &capKey);
+
+    static unsigned long long requireWhole(const JsonValue &value, const std::string &key, unsigned long long max);
+
+    static MaxFlowEngine optionalEngine(const JsonValue &query);
+
+    static PathSearch optionalSearch(const JsonValue &query);
+
+    static unsigned int optionalCount(const JsonValue &query, unsigned int defaultCount);
+
+    ServiceCostModel optionalCosts(const JsonValue &query) const;
+
+    JsonValue maxFlowQuery(const JsonValue &query);
+
+    JsonValue incomingFluxQuery(const JsonValue &query);
+
+    JsonValue networkMaxFlowQuery();
+
+    JsonValue topGroupingsQuery(const JsonValue &query, const StationGrouping &group);
+
+    JsonValue minCostQuery(const JsonValue &query);
+
+    JsonValue failureQuery(const JsonValue &query);
+
+    JsonValue topReductionsQuery(const JsonValue &query);
+
+    JsonValue contingencyQuery(const JsonValue &query);
+
+    JsonValue scenariosQuery(const JsonValue &query);
+
+    JsonValue multiFlowQuery(const JsonValue &query);
+
+    JsonValue multiCommodityQuery(const JsonValue &query);
+
+    JsonValue regionReportQuery(const JsonValue &query);
+
+    JsonValue stationSearchQuery(const JsonValue &query);
+
+    JsonValue cacheStatsQuery() const;
+
+  public:
+    QueryProcessor(Graph &graph, Graph &residualGraph, DataRepository &dataRepository, FlowCache &flowCache);
+
+    void setFluxWorkers(unsigned int numWorkers);
+
+    JsonValue processQuery(const JsonValue &query);
+
+    std::string processLine(const std::string &line);
+
+    unsigned int processStream(std::istream &in, std::ostream &out);
+};
+
+
+#endif //RAILWAYMANAGEMENT_QUERYPROCESSOR_H
@@ -0,0 +1,200 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include "queryServer.h"
+
+using namespace std;
+
+std::atomic<bool> QueryServer::stopRequested(false);
+
+QueryServer::WorkerNetwork::WorkerNetwork(const Graph &network, DataRepository &dataRepository,
+                                          FlowCache &flowCache)
+        : queryProcessor(graph, residualGraph, dataRepository, flowCache) {
+    network.copyNetwork(graph, residualGraph);
+}
+
+/**
+ * Prepares a server for an already loaded network. Since flow queries store their state in the network's edges, each
+ * worker gets its own copy of the network, so that queries can run concurrently without reloading the dataset. The
+ * copies share the same topology version, so max flow and min cost results are cached once for every worker
+ * Time Complexity: O(w(|V|+|E|)), w being the number of workers
+ * @param graph - Loaded network to serve queries about
+ * @param dataRepository - Loaded station data, shared (read-only) by every worker
+ * @param numWorkers - Number of queries that can be executed at the same time
+ */
+QueryServer::QueryServer(const Graph &graph, DataRepository &dataRepository, unsigned int numWorkers)
+        : threadPool(numWorkers) {
+    for (unsigned int i = 0; i < threadPool.getNumWorkers(); i++)
+        workerNetworks.push_back(make_unique<WorkerNetwork>(graph, dataRepository, flowCache));
+}
+
+/**
+ * Asks a running server to stop accepting connections and return from run(). Safe to call from a signal handler
+ */
+void QueryServer::requestStop() {
+    stopRequested = true;
+}
+
+bool QueryServer::sendAll(int fd, const string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += (size_t) n;
+    }
+    return true;
+}
+
+QueryServer::Connection::Connection(int fd) : fd(fd) {}
+
+/**
+ * Reads what a client sent, splitting it into queries (one JSON object per line) that are dispatched to the worker pool
+ * @param connection - Connection with data (or a hang up) waiting to be read
+ */
+void QueryServer::readQueries(const shared_ptr<Connection> &connection) {
+    char chunk[4096];
+    ssize_t n = recv(connection->fd, chunk, sizeof(chunk), 0);
+    if (n < 0 && errno == EINTR) return;
+
+    lock_guard<mutex> lock(connectionsMutex);
+    if (n <= 0) {
+        connection->hungUp = true;
+        return;
+    }
+    connection->buffer.append(chunk, (size_t) n);
+
+    size_t newline;
+    while ((newline = connection->buffer.find('\n')) != string::npos) {
+        string line = connection->buffer.substr(0, newline);
+        connection->buffer.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") != string::npos) connection->queries.push_back(move(line));
+    }
+    dispatch(connection);
+}
+
+/**
+ * Hands the next query of a connection to the worker pool, unless one of its queries is already there: a connection
+ * has at most one query in the pool at a time, so that its answers are sent in the order of its queries, while a
+ * worker is only taken for as long as a query runs. Must be called with connectionsMutex locked
+ * @param connection - Connection whose next query to dispatch
+ */
+void QueryServer::dispatch(const shared_ptr<Connection> &connection) {
+    if (connection->busy || connection->queries.empty()) return;
+    if (stopRequested) {
+        connection->queries.clear();
+        return;
+    }
+    connection->busy = true;
+    string query = move(connection->queries.front());
+    connection->queries.pop_front();
+    threadPool.submit([this, connection, query](unsigned int workerId) { answer(connection, query, workerId); });
+}
+
+/**
+ * Executes a query on the copy of the network of the worker running it, sends the result to the client and dispatches
+ * the connection's next query
+ * @param connection - Connection the query came from
+ * @param query - Query serialized as a JSON object
+ * @param workerId - Id of the worker running the query
+ */
+void QueryServer::answer(const shared_ptr<Connection> &connection, const string &query, unsigned int workerId) {
+    string response;
+    try {
+        response = workerNetworks[workerId]->queryProcessor.processLine(query);
+    } catch (const exception &e) {
+        JsonValue error = JsonValue::object();
+        error.set("status", "error");
+        error.set("message", e.what());
+        response = error.dump();
+    }
+    bool sent = sendAll(connection->fd, response + '\n');
+
+    lock_guard<mutex> lock(connectionsMutex);
+    connection->busy = false;
+    if (!sent) {
+        connection->hungUp = true;
+        connection->queries.clear();
+    }
+    dispatch(connection);
+}
+
+/**
+ * Listens for connections on a Unix domain socket until requestStop() is called. This thread accepts the connections
+ * and reads their queries, and every query is run as its own task of the worker pool, so queries from different
+ * connections run concurrently and any number of clients can stay connected
+ * @param socketPath - Path of the socket file to create (an existing file at this path is replaced)
+ * @return True if the server ran and stopped normally, false if the socket couldn't be created
+ */
+bool QueryServer::run(const string &socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "The socket path " << socketPath << " is too long." << endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        cerr << "Couldn't create the socket: " << strerror(errno) << endl;
+        return false;
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (sockaddr *) &address, sizeof(address)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        cerr << "Couldn't listen on " << socketPath << ": " << strerror(errno) << endl;
+        close(listenFd);
+        return false;
+    }
+
+    cout << "Serving queries on " << socketPath << " with " << threadPool.getNumWorkers() << " workers." << endl;
+
+    while (!stopRequested) {
+        vector<pollfd> pfds{{listenFd, POLLIN, 0}};
+        vector<shared_ptr<Connection>> polled;
+        {
+            lock_guard<mutex> lock(connectionsMutex);
+            // A connection is closed once it hung up and its last query was answered
+            auto finished = remove_if(connections.begin(), connections.end(), [](const shared_ptr<Connection> &c) {
+                if (!c->hungUp || c->busy) return false;
+                close(c->fd);
+                return true;
+            });
+            connections.erase(finished, connections.end());
+            for (const shared_ptr<Connection> &connection: connections) {
+                if (connection->hungUp) continue;
+                pfds.push_back({connection->fd, POLLIN, 0});
+                polled.push_back(connection);
+            }
+        }
+
+        int ready = poll(pfds.data(), pfds.size(), 200);
+        if (ready <= 0) continue;
+        for (size_t i = 1; i < pfds.size(); i++)
+            if (pfds[i].revents != 0) readQueries(polled[i - 1]);
+
+        if (pfds[0].revents & POLLIN) {
+            int clientFd = accept(listenFd, nullptr, nullptr);
+            if (clientFd < 0) continue;
+            lock_guard<mutex> lock(connectionsMutex);
+            connections.push_back(make_shared<Connection>(clientFd));
+        }
+    }
+
+    close(listenFd);
+    threadPool.wait(); // queries already running are answered, the waiting ones are dropped
+    for (const shared_ptr<Connection> &connection: connections) close(connection->fd);
+    connections.clear();
+    unlink(socketPath.c_str());
+    return true;
+}
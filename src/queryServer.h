@@ -0,0 +1,65 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_QUERYSERVER_H
+#define RAILWAYMANAGEMENT_QUERYSERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include "graph.h"
+#include "dataRepository.h"
+#include "queryProcessor.h"
+#include "threadPool.h"
+#include "flowCache.h"
+
+class QueryServer {
+  private:
+    struct WorkerNetwork {
+        Graph graph;
+        Graph residualGraph;
+        QueryProcessor queryProcessor;
+
+        WorkerNetwork(const Graph &network, DataRepository &dataRepository, FlowCache &flowCache);
+    };
+
+    struct Connection {
+        int fd;
+        std::string buffer; // received data not yet split into queries
+        std::deque<std::string> queries; // complete queries waiting for the previous one to be answered
+        bool busy = false; // one of its queries is queued in or running on the worker pool
+        bool hungUp = false; // the client won't send (or receive) anything else
+
+        explicit Connection(int fd);
+    };
+
+    FlowCache flowCache; // shared by every worker
+
+    std::vector<std::unique_ptr<WorkerNetwork>> workerNetworks;
+    ThreadPool threadPool;
+    std::vector<std::shared_ptr<Connection>> connections; // only the thread in run() adds and removes connections
+    std::mutex connectionsMutex; // guards the queries, busy and hungUp of every Connection
+    static std::atomic<bool> stopRequested;
+
+    void readQueries(const std::shared_ptr<Connection> &connection);
+
+    void dispatch(const std::shared_ptr<Connection> &connection);
+
+    void answer(const std::shared_ptr<Connection> &connection, const std::string &query, unsigned int workerId);
+
+    static bool sendAll(int fd, const std::string &data);
+
+  public:
+    QueryServer(const Graph &graph, DataRepository &dataRepository, unsigned int numWorkers);
+
+    bool run(const std::string &socketPath);
+
+    static void requestStop();
+};
+
+
+#endif //RAILWAYMANAGEMENT_QUERYSERVER_H
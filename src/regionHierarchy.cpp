@@ -0,0 +1,153 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include "regionHierarchy.h"
+
+double RegionTotals::average() const {
+    return count == 0 ? 0 : sum / count;
+}
+
+RegionHierarchy::RegionHierarchy() = default;
+
+/**
+ * Links every station to its township, every township to its municipality and every municipality to its district.
+ * Townships and municipalities are nodes of the hierarchy per (district, municipality, township) path, so that regions
+ * sharing a name in different parents are kept apart inside the hierarchy
+ * Time Complexity: O(n log(l)), n being the number of stations and l that of leaves
+ * @param stations - Stations, indexed by id
+ * @param districts - Dictionary of the stations' districts
+ * @param municipalities - Dictionary of the stations' municipalities
+ * @param townships - Dictionary of the stations' townships
+ */
+void RegionHierarchy::build(const std::vector<Station> &stations, const Dictionary &districts,
+                            const Dictionary &municipalities, const Dictionary &townships) {
+    names[(unsigned int) RegionLevel::DISTRICT] = &districts;
+    names[(unsigned int) RegionLevel::MUNICIPALITY] = &municipalities;
+    names[(unsigned int) RegionLevel::TOWNSHIP] = &townships;
+    stationLeaf.clear();
+    leafTownship.clear();
+    leafParent.clear();
+    municipalityNodeName.clear();
+    municipalityNodeDistrict.clear();
+
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> municipalityNodes;
+    std::map<std::tuple<unsigned int, unsigned int, unsigned int>, unsigned int> leaves;
+    for (const Station &s: stations) {
+        auto [municipality, newMunicipality] = municipalityNodes.emplace(
+                std::make_pair(s.getDistrict(), s.getMunicipality()), (unsigned int) municipalityNodeName.size());
+        if (newMunicipality) {
+            municipalityNodeName.push_back(s.getMunicipality());
+            municipalityNodeDistrict.push_back(s.getDistrict());
+        }
+        auto [leaf, newLeaf] = leaves.emplace(std::make_tuple(s.getDistrict(), s.getMunicipality(), s.getTownship()),
+                                              (unsigned int) leafTownship.size());
+        if (newLeaf) {
+            leafTownship.push_back(s.getTownship());
+            leafParent.push_back(municipality->second);
+        }
+        stationLeaf.push_back(leaf->second);
+    }
+}
+
+unsigned int RegionHierarchy::getNumLeaves() const {
+    return (unsigned int) leafTownship.size();
+}
+
+/**
+ * Sums a per-station metric up the hierarchy (see RegionRollup)
+ * Time Complexity: O(n + l + r), n being the number of stations, l that of leaves and r that of region names
+ * @param stationMetric - Value of the metric for each station id
+ * @return RegionRollup with the totals of every region
+ */
+RegionRollup RegionHierarchy::rollUp(const std::vector<double> &stationMetric) const {
+    return {*this, stationMetric};
+}
+
+/**
+ * Sums a per-station metric into the leaves of the hierarchy in one pass over the stations, and then the leaves into
+ * their municipalities and these into their districts. The totals of each level are kept per region name, as in the
+ * DataRepository's groupings
+ * Time Complexity: O(n + l + r), n being the number of stations, l that of leaves and r that of region names
+ * @param hierarchy - Hierarchy of the regions
+ * @param stationMetric - Value of the metric for each station id
+ */
+RegionRollup::RegionRollup(const RegionHierarchy &hierarchy, const std::vector<double> &stationMetric)
+        : hierarchy(&hierarchy), leafTotals(hierarchy.getNumLeaves()) {
+    for (unsigned int station = 0; station < hierarchy.stationLeaf.size(); station++) {
+        RegionTotals &totals = leafTotals[hierarchy.stationLeaf[station]];
+        totals.sum += stationMetric[station];
+        totals.count++;
+    }
+
+    for (unsigned int level = 0; level < 3; level++) levelTotals[level].resize(hierarchy.names[level]->size());
+    std::vector<RegionTotals> municipalityNodeTotals(hierarchy.municipalityNodeName.size());
+    for (unsigned int leaf = 0; leaf < leafTotals.size(); leaf++) {
+        RegionTotals &township = levelTotals[(unsigned int) RegionLevel::TOWNSHIP][hierarchy.leafTownship[leaf]];
+        RegionTotals &parent = municipalityNodeTotals[hierarchy.leafParent[leaf]];
+        township.sum += leafTotals[leaf].sum;
+        township.count += leafTotals[leaf].count;
+        parent.sum += leafTotals[leaf].sum;
+        parent.count += leafTotals[leaf].count;
+    }
+    for (unsigned int node = 0; node < municipalityNodeTotals.size(); node++) {
+        RegionTotals &municipality =
+                levelTotals[(unsigned int) RegionLevel::MUNICIPALITY][hierarchy.municipalityNodeName[node]];
+        RegionTotals &district = levelTotals[(unsigned int) RegionLevel::DISTRICT][hierarchy.municipalityNodeDistrict[node]];
+        municipality.sum += municipalityNodeTotals[node].sum;
+        municipality.count += municipalityNodeTotals[node].count;
+        district.sum += municipalityNodeTotals[node].sum;
+        district.count += municipalityNodeTotals[node].count;
+    }
+}
+
+const RegionTotals &RegionRollup::getTotals(RegionLevel level, unsigned int region) const {
+    return levelTotals[(unsigned int) level][region];
+}
+
+/**
+ * Orders the regions of a level by decreasing average of the metric, with ties ordered by name, as topGroupings does
+ * Time Complexity: O(r log(r)), r being the number of regions of the level
+ * @param level - Level of the regions
+ * @return Vector of pairs with the name of each region and its average
+ */
+std::vector<std::pair<std::string, double>> RegionRollup::ranking(RegionLevel level) const {
+    const std::vector<RegionTotals> &totals = levelTotals[(unsigned int) level];
+    const Dictionary &names = *hierarchy->names[(unsigned int) level];
+    std::vector<std::pair<std::string, double>> result;
+    for (unsigned int region = 0; region < totals.size(); region++)
+        if (totals[region].count > 0) result.emplace_back(names.getName(region), totals[region].average());
+    std::sort(result.begin(), result.end(), [](const auto &left, const auto &right) {
+        if (left.second != right.second) return left.second > right.second;
+        return left.first < right.first;
+    });
+    return result;
+}
+
+/**
+ * Totals of a user-defined region made of regions of any level (e.g. two districts and a municipality of a third one).
+ * Stations covered by more than one of the regions are only counted once
+ * Time Complexity: O(l + s), l being the number of leaves and s the number of regions given
+ * @param regions - Level and name id of each region
+ * @return Totals of the union of the regions
+ */
+RegionTotals RegionRollup::combine(const std::vector<std::pair<RegionLevel, unsigned int>> &regions) const {
+    std::vector<bool> selected[3];
+    for (unsigned int level = 0; level < 3; level++) selected[level].assign(levelTotals[level].size(), false);
+    for (const auto &[level, region]: regions) selected[(unsigned int) level][region] = true;
+
+    RegionTotals result;
+    for (unsigned int leaf = 0; leaf < leafTotals.size(); leaf++) {
+        unsigned int node = hierarchy->leafParent[leaf];
+        if (selected[(unsigned int) RegionLevel::TOWNSHIP][hierarchy->leafTownship[leaf]] ||
+            selected[(unsigned int) RegionLevel::MUNICIPALITY][hierarchy->municipalityNodeName[node]] ||
+            selected[(unsigned int) RegionLevel::DISTRICT][hierarchy->municipalityNodeDistrict[node]]) {
+            result.sum += leafTotals[leaf].sum;
+            result.count += leafTotals[leaf].count;
+        }
+    }
+    return result;
+}
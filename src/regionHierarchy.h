@@ -0,0 +1,69 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_REGIONHIERARCHY_H
+#define RAILWAYMANAGEMENT_REGIONHIERARCHY_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "station.h"
+#include "dictionary.h"
+
+enum class RegionLevel : unsigned int {
+    DISTRICT = 0,
+    MUNICIPALITY = 1,
+    TOWNSHIP = 2
+};
+
+struct RegionTotals {
+    double sum = 0;
+    unsigned int count = 0; // number of stations
+
+    [[nodiscard]] double average() const;
+};
+
+class RegionRollup;
+
+class RegionHierarchy {
+  private:
+    const Dictionary *names[3] = {nullptr, nullptr, nullptr}; // indexed by RegionLevel
+    std::vector<unsigned int> stationLeaf; // leaf of each station
+    // leaves are the distinct (district, municipality, township) triples, and belong to a (district, municipality) node
+    std::vector<unsigned int> leafTownship;
+    std::vector<unsigned int> leafParent;
+    std::vector<unsigned int> municipalityNodeName;
+    std::vector<unsigned int> municipalityNodeDistrict;
+
+    friend class RegionRollup;
+
+  public:
+    RegionHierarchy();
+
+    void build(const std::vector<Station> &stations, const Dictionary &districts, const Dictionary &municipalities,
+               const Dictionary &townships);
+
+    [[nodiscard]] unsigned int getNumLeaves() const;
+
+    [[nodiscard]] RegionRollup rollUp(const std::vector<double> &stationMetric) const;
+};
+
+class RegionRollup {
+  private:
+    const RegionHierarchy *hierarchy;
+    std::vector<RegionTotals> leafTotals;
+    std::vector<RegionTotals> levelTotals[3]; // per region name of each level, indexed by RegionLevel
+
+  public:
+    RegionRollup(const RegionHierarchy &hierarchy, const std::vector<double> &stationMetric);
+
+    [[nodiscard]] const RegionTotals &getTotals(RegionLevel level, unsigned int region) const;
+
+    [[nodiscard]] std::vector<std::pair<std::string, double>> ranking(RegionLevel level) const;
+
+    [[nodiscard]] RegionTotals combine(const std::vector<std::pair<RegionLevel, unsigned int>> &regions) const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_REGIONHIERARCHY_H
@@ -0,0 +1,103 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "scenario.h"
+#include "graph.h"
+
+/**
+ * Creates a scenario with no changes over a network
+ * Time Complexity: O(r/64)
+ * @param numRails - Number of rails of the base network
+ */
+Scenario::Scenario(unsigned int numRails) : numRails(numRails), failed((numRails + 63) / 64, 0) {}
+
+unsigned int Scenario::getNumRails() const {
+    return numRails;
+}
+
+void Scenario::fail(unsigned int rail) {
+    failed[rail / 64] |= 1ULL << (rail % 64);
+}
+
+void Scenario::repair(unsigned int rail) {
+    failed[rail / 64] &= ~(1ULL << (rail % 64));
+}
+
+bool Scenario::isFailed(unsigned int rail) const {
+    return (failed[rail / 64] >> (rail % 64)) & 1;
+}
+
+/**
+ * Lists the failed rails
+ * Time Complexity: O(r/64 + 64w), w being the number of 64-rail words with failed rails
+ * @return Indexes of the failed rails, in increasing order
+ */
+std::vector<unsigned int> Scenario::getFailedRails() const {
+    std::vector<unsigned int> rails;
+    for (unsigned int word = 0; word < failed.size(); word++) {
+        if (failed[word] == 0) continue;
+        for (unsigned int bit = 0; bit < 64; bit++)
+            if ((failed[word] >> bit) & 1) rails.push_back(word * 64 + bit);
+    }
+    return rails;
+}
+
+const std::vector<unsigned long long> &Scenario::getFailedMask() const {
+    return failed;
+}
+
+void Scenario::setCapacity(unsigned int rail, Capacity capacity) {
+    capacities[rail] = capacity;
+}
+
+/**
+ * Finds the capacity a rail has in this scenario, if it changes
+ * Time Complexity: O(1) (average case)
+ * @param rail - Index of the rail
+ * @return optional<Capacity> with the rail's new capacity, or empty if it keeps its capacity
+ */
+std::optional<Capacity> Scenario::getCapacity(unsigned int rail) const {
+    auto it = capacities.find(rail);
+    if (it == capacities.end()) return std::nullopt;
+    return it->second;
+}
+
+const std::unordered_map<unsigned int, Capacity> &Scenario::getCapacityChanges() const {
+    return capacities;
+}
+
+/**
+ * Applies a scenario to a Graph (normally, a worker's copy of the base network): its failed rails that are active are
+ * deactivated and the capacities it changes are set
+ * Time Complexity: O(r/64 + 64w) plus O(|E|) if capacities change, w being the number of 64-rail words with failures
+ * @param graph - Graph with the same rails as the scenario's base network
+ * @param scenario - Scenario to apply
+ */
+AppliedScenario::AppliedScenario(Graph &graph, const Scenario &scenario) : graph(graph) {
+    deactivated = graph.deactivateRails(scenario.getFailedMask());
+
+    std::vector<std::pair<Edge *, Capacity>> changes;
+    for (const auto &[rail, capacity]: scenario.getCapacityChanges()) {
+        previousCapacities.emplace_back(graph.getRail(rail), graph.getRail(rail)->getCapacity());
+        changes.emplace_back(graph.getRail(rail), capacity);
+    }
+    if (!changes.empty()) graph.setRailCapacities(changes);
+}
+
+/**
+ * Deactivates the given rails of a Graph that are active
+ * Time Complexity: O(|E|/64 + f), f being the number of failed rails
+ * @param graph - Graph the rails belong to
+ * @param failedRails - Rails to deactivate
+ */
+AppliedScenario::AppliedScenario(Graph &graph, const std::vector<Edge *> &failedRails) : graph(graph) {
+    std::vector<unsigned long long> mask((graph.getTotalEdges() + 63) / 64, 0);
+    for (Edge const *rail: failedRails) mask[rail->getIndex() / 64] |= 1ULL << (rail->getIndex() % 64);
+    deactivated = graph.deactivateRails(mask);
+}
+
+AppliedScenario::~AppliedScenario() {
+    if (!previousCapacities.empty()) graph.setRailCapacities(previousCapacities);
+    graph.activateRails(deactivated);
+}
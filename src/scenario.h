@@ -0,0 +1,70 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_SCENARIO_H
+#define RAILWAYMANAGEMENT_SCENARIO_H
+
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include "edge.h"
+
+class Graph;
+
+/**
+ * What-if variant of a network, stored as a sparse overlay of changes to its rails (indexed as in the base Graph): a
+ * bitset of failed rails and the rails whose capacity changes. The base network is never modified by a Scenario
+ */
+class Scenario {
+  private:
+    unsigned int numRails;
+    std::vector<unsigned long long> failed; // one bit per rail
+    std::unordered_map<unsigned int, Capacity> capacities; // rails whose capacity changes, with their new capacity
+
+  public:
+    explicit Scenario(unsigned int numRails);
+
+    [[nodiscard]] unsigned int getNumRails() const;
+
+    void fail(unsigned int rail);
+
+    void repair(unsigned int rail);
+
+    [[nodiscard]] bool isFailed(unsigned int rail) const;
+
+    [[nodiscard]] std::vector<unsigned int> getFailedRails() const;
+
+    [[nodiscard]] const std::vector<unsigned long long> &getFailedMask() const;
+
+    void setCapacity(unsigned int rail, Capacity capacity);
+
+    [[nodiscard]] std::optional<Capacity> getCapacity(unsigned int rail) const;
+
+    [[nodiscard]] const std::unordered_map<unsigned int, Capacity> &getCapacityChanges() const;
+};
+
+/**
+ * Applies a scenario (or a set of failed rails) to a Graph for as long as it exists, undoing exactly the changes it made
+ * when destroyed, so that the network is restored even if the computation in between throws
+ */
+class AppliedScenario {
+  private:
+    Graph &graph;
+    std::vector<unsigned long long> deactivated; // bitset of the rails it deactivated
+    std::vector<std::pair<Edge *, Capacity>> previousCapacities;
+
+  public:
+    AppliedScenario(Graph &graph, const Scenario &scenario);
+
+    AppliedScenario(Graph &graph, const std::vector<Edge *> &failedRails);
+
+    AppliedScenario(const AppliedScenario &) = delete;
+
+    AppliedScenario &operator=(const AppliedScenario &) = delete;
+
+    ~AppliedScenario();
+};
+
+
+#endif //RAILWAYMANAGEMENT_SCENARIO_H
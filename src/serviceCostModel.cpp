@@ -0,0 +1,133 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include "serviceCostModel.h"
+
+/**
+ * Creates a cost model with the built-in services and their default costs per train
+ * Time Complexity: O(1)
+ */
+ServiceCostModel::ServiceCostModel() {
+    setCost(intern("STANDARD"), 2);
+    setCost(intern("ALFA PENDULAR"), 4);
+    setCost(intern("VERY EXPENSIVE"), 6);
+}
+
+/**
+ * Finds the service with the given name, adding it (without a cost) if it wasn't in the model yet
+ * Time Complexity: O(1) (average case)
+ * @param name - Name of the service, as written in the network and cost files
+ * @return The service
+ */
+Service ServiceCostModel::intern(const std::string &name) {
+    unsigned int id = services.intern(name);
+    if (id == trainCosts.size()) {
+        trainCosts.push_back(0);
+        kmCosts.push_back(0);
+        priced.push_back(false);
+    }
+    return (Service) id;
+}
+
+/**
+ * Finds the service with the given name, without adding it
+ * Time Complexity: O(1) (average case)
+ * @param name - Name of the service
+ * @return optional<Service> with the service, or empty if it isn't in the model
+ */
+std::optional<Service> ServiceCostModel::find(const std::string &name) const {
+    std::optional<unsigned int> id = services.find(name);
+    if (!id.has_value()) return std::nullopt;
+    return (Service) *id;
+}
+
+const std::string &ServiceCostModel::getName(Service service) const {
+    return services.getName((unsigned int) service);
+}
+
+unsigned int ServiceCostModel::size() const {
+    return services.size();
+}
+
+bool ServiceCostModel::isPriced(Service service) const {
+    return (unsigned int) service < priced.size() && priced[(unsigned int) service];
+}
+
+Cost ServiceCostModel::getTrainCost(Service service) const {
+    return (unsigned int) service < trainCosts.size() ? trainCosts[(unsigned int) service] : 0;
+}
+
+double ServiceCostModel::getKmCost(Service service) const {
+    return (unsigned int) service < kmCosts.size() ? kmCosts[(unsigned int) service] : 0;
+}
+
+/**
+ * Cost of a train using a rail of a service: its cost per train plus its cost per km times the rail's length, rounded
+ * to the nearest unit
+ * Time Complexity: O(1)
+ * @param service - Service of the rail
+ * @param length - Length of the rail in km (0 if unknown)
+ * @return Cost of each train using the rail
+ */
+Cost ServiceCostModel::getCost(Service service, unsigned int length) const {
+    return getTrainCost(service) + (Cost) std::llround(getKmCost(service) * length);
+}
+
+/**
+ * Sets the cost of a service. Negative costs are rejected, as they would make every rail a negative cycle (there and
+ * back) and min cost queries would never finish
+ * Time Complexity: O(1)
+ * @param service - Service, as returned by intern
+ * @param trainCost - Cost of each train using a rail of the service
+ * @param kmCost - Extra cost of each train per km of rail
+ */
+void ServiceCostModel::setCost(Service service, Cost trainCost, double kmCost) {
+    if (trainCost < 0) throw std::invalid_argument("The cost of a service can't be negative");
+    if (!std::isfinite(kmCost) || kmCost < 0)
+        throw std::invalid_argument("The cost per km of a service must be a finite, non-negative number");
+    trainCosts[(unsigned int) service] = trainCost;
+    kmCosts[(unsigned int) service] = kmCost;
+    priced[(unsigned int) service] = true;
+}
+
+/**
+ * Reads service costs in CSV format (a header line, then "Service,Cost" or "Service,Cost,Cost_Per_Km" lines), adding
+ * the services that weren't in the model yet and replacing the costs of the ones that were
+ * Time Complexity: O(n) (average case), n being the number of lines
+ * @param in - Stream to read from
+ * @return Number of services read; throws std::invalid_argument on a malformed line or an invalid cost
+ */
+unsigned int ServiceCostModel::load(std::istream &in) {
+    std::string line;
+    std::getline(in, line); //Ignore first line with just descriptors
+
+    unsigned int count = 0;
+    for (unsigned int lineNumber = 2; std::getline(in, line); lineNumber++) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        std::vector<std::string> fields;
+        std::istringstream iss(line);
+        for (std::string field; std::getline(iss, field, ',');) fields.push_back(field);
+        try {
+            if (fields.size() < 2 || fields.size() > 3 || fields[0].empty()) throw std::invalid_argument("");
+            size_t used;
+            Cost trainCost = std::stoll(fields[1], &used);
+            if (used != fields[1].size()) throw std::invalid_argument("");
+            double kmCost = 0;
+            if (fields.size() == 3 && !fields[2].empty()) {
+                kmCost = std::stod(fields[2], &used);
+                if (used != fields[2].size()) throw std::invalid_argument("");
+            }
+            setCost(intern(fields[0]), trainCost, kmCost);
+            count++;
+        } catch (const std::logic_error &) {
+            throw std::invalid_argument("Malformed service cost on line " + std::to_string(lineNumber));
+        }
+    }
+    return count;
+}
@@ -0,0 +1,47 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_SERVICECOSTMODEL_H
+#define RAILWAYMANAGEMENT_SERVICECOSTMODEL_H
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <istream>
+#include "dictionary.h"
+#include "edge.h"
+
+class ServiceCostModel {
+  private:
+    Dictionary services;          // the ids of the built-in services are the values of the Service enum
+    std::vector<Cost> trainCosts; // cost of each train using a rail, indexed by service id
+    std::vector<double> kmCosts;  // extra cost per km of rail, indexed by service id
+    std::vector<bool> priced;     // whether the service was given a cost, indexed by service id
+
+  public:
+    ServiceCostModel();
+
+    Service intern(const std::string &name);
+
+    [[nodiscard]] std::optional<Service> find(const std::string &name) const;
+
+    [[nodiscard]] const std::string &getName(Service service) const;
+
+    [[nodiscard]] unsigned int size() const;
+
+    [[nodiscard]] bool isPriced(Service service) const;
+
+    [[nodiscard]] Cost getTrainCost(Service service) const;
+
+    [[nodiscard]] double getKmCost(Service service) const;
+
+    [[nodiscard]] Cost getCost(Service service, unsigned int length) const;
+
+    void setCost(Service service, Cost trainCost, double kmCost = 0);
+
+    unsigned int load(std::istream &in);
+};
+
+
+#endif //RAILWAYMANAGEMENT_SERVICECOSTMODEL_H
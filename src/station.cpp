@@ -7,12 +7,10 @@
 
 Station::Station() = default;
 
-Station::Station(std::string name, std::string district, std::string municipality,
-                 std::string township,
-                 std::string line) : name(std::move(name)), district(std::move(district)), municipality(std::move(municipality)),
-                                            township(std::move(township)), line(std::move(line)) {}
-
-Station::Station(std::string name) : name(std::move(name)) {}
+Station::Station(std::string name, unsigned int id, unsigned int district, unsigned int municipality,
+                 unsigned int township,
+                 unsigned int line) : name(std::move(name)), id(id), district(district), municipality(municipality),
+                                      township(township), line(line) {}
 
 //Getters
 
@@ -20,19 +18,23 @@ const std::string &Station::getName() const {
     return name;
 }
 
-const std::string &Station::getDistrict() const {
+unsigned int Station::getId() const {
+    return id;
+}
+
+unsigned int Station::getDistrict() const {
     return district;
 }
 
-const std::string &Station::getMunicipality() const {
+unsigned int Station::getMunicipality() const {
     return municipality;
 }
 
-const std::string &Station::getTownship() const {
+unsigned int Station::getTownship() const {
     return township;
 }
 
-const std::string &Station::getLine() const {
+unsigned int Station::getLine() const {
     return line;
 }
 
@@ -40,30 +42,22 @@ void Station::setName(const std::string &name) {
     Station::name = name;
 }
 
-void Station::setDistrict(const std::string &district) {
+void Station::setId(unsigned int id) {
+    Station::id = id;
+}
+
+void Station::setDistrict(unsigned int district) {
     Station::district = district;
 }
 
-void Station::setMunicipality(const std::string &municipality) {
+void Station::setMunicipality(unsigned int municipality) {
     Station::municipality = municipality;
 }
 
-void Station::setTownship(const std::string &township) {
+void Station::setTownship(unsigned int township) {
     Station::township = township;
 }
 
-void Station::setLine(const std::string &line) {
+void Station::setLine(unsigned int line) {
     Station::line = line;
 }
-
-Station &Station::operator=(const Station &station) {
-    this->name = station.name;
-    this->district = station.district;
-    this->municipality = station.municipality;
-    this->line = station.line;
-    return *this;
-}
-
-
-
-
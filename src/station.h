@@ -6,65 +6,47 @@
 #define RAILWAYMANAGEMENT_STATION_H
 
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 
 class Station {
 private:
     std::string name;
-    std::string district;
-    std::string municipality;
-    std::string township;
-    std::string line;
+    unsigned int id = 0;
+    // ids in the DataRepository's dictionaries
+    unsigned int district = 0;
+    unsigned int municipality = 0;
+    unsigned int township = 0;
+    unsigned int line = 0;
 public:
     Station();
 
-    Station(std::string name, std::string district, std::string municipality,
-            std::string township,
-            std::string line);
-
-    explicit Station(std::string name);
+    Station(std::string name, unsigned int id, unsigned int district, unsigned int municipality,
+            unsigned int township,
+            unsigned int line);
 
     [[nodiscard]] const std::string &getName() const;
 
-    [[nodiscard]] const std::string &getDistrict() const;
-
-    [[nodiscard]] const std::string &getMunicipality() const;
+    [[nodiscard]] unsigned int getId() const;
 
-    [[nodiscard]] const std::string &getTownship() const;
+    [[nodiscard]] unsigned int getDistrict() const;
 
-    [[nodiscard]] const std::string &getLine() const;
+    [[nodiscard]] unsigned int getMunicipality() const;
 
-    void setName(const std::string &name);
+    [[nodiscard]] unsigned int getTownship() const;
 
-    void setDistrict(const std::string &district);
+    [[nodiscard]] unsigned int getLine() const;
 
-    void setMunicipality(const std::string &municipality);
+    void setName(const std::string &name);
 
-    void setTownship(const std::string &township);
+    void setId(unsigned int id);
 
-    void setLine(const std::string &line);
+    void setDistrict(unsigned int district);
 
-    Station &operator=(const Station &station);
-};
+    void setMunicipality(unsigned int municipality);
 
+    void setTownship(unsigned int township);
 
-struct StationHash {
-    std::size_t operator()(const Station &Station) const {
-        return std::hash<std::string>()(Station.getName());
-    }
+    void setLine(unsigned int line);
 };
 
-struct StationEquals {
-    bool operator()(const Station &Station1, const Station &Station2) const {
-        return Station1.getName() == Station2.getName();
-    }
-};
-
-typedef std::unordered_set<Station, StationHash, StationEquals> stationTable;
-
-template<typename T>
-using StationMap = std::unordered_map<Station, T, StationHash, StationEquals>;
-
 
 #endif //RAILWAYMANAGEMENT_STATION_H
@@ -0,0 +1,86 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "stationGrouping.h"
+
+StationSpan::StationSpan() = default;
+
+StationSpan::StationSpan(const unsigned int *first, const unsigned int *last) : first(first), last(last) {}
+
+const unsigned int *StationSpan::begin() const {
+    return first;
+}
+
+const unsigned int *StationSpan::end() const {
+    return last;
+}
+
+size_t StationSpan::size() const {
+    return last - first;
+}
+
+bool StationSpan::empty() const {
+    return first == last;
+}
+
+unsigned int StationSpan::operator[](size_t i) const {
+    return first[i];
+}
+
+StationGrouping::StationGrouping() = default;
+
+/**
+ * Groups the stations of a table by one of their administrative regions, storing the ids of the stations of every group
+ * next to each other (in increasing order), as in a compressed sparse row matrix
+ * Time Complexity: O(n + g), n being the number of stations and g the number of groups
+ * @param groupNames - Dictionary with the names of the groups
+ * @param stationTable - Stations, indexed by id
+ * @param groupOf - Station getter returning the id of the station's group
+ */
+void StationGrouping::build(const Dictionary &groupNames, const std::vector<Station> &stationTable,
+                            unsigned int (Station::*groupOf)() const) {
+    names = &groupNames;
+    stations = &stationTable;
+
+    offsets.assign(groupNames.size() + 1, 0);
+    for (const Station &s: stationTable) offsets[(s.*groupOf)() + 1]++;
+    for (unsigned int g = 0; g < groupNames.size(); g++) offsets[g + 1] += offsets[g];
+
+    members.resize(stationTable.size());
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    for (const Station &s: stationTable) members[next[(s.*groupOf)()]++] = s.getId();
+}
+
+unsigned int StationGrouping::size() const {
+    return offsets.empty() ? 0 : (unsigned int) offsets.size() - 1;
+}
+
+const std::string &StationGrouping::getName(unsigned int group) const {
+    return names->getName(group);
+}
+
+/**
+ * Finds the group with the given name
+ * Time Complexity: O(1) (average case) | O(g) (worst case), g being the number of groups
+ * @param name - Name of the group
+ * @return optional<unsigned int> with the id of the group, or empty if there is no such group
+ */
+std::optional<unsigned int> StationGrouping::find(const std::string &name) const {
+    if (names == nullptr) return std::nullopt;
+    return names->find(name);
+}
+
+/**
+ * Finds the stations of a group, without copying them
+ * Time Complexity: O(1)
+ * @param group - Id of the group
+ * @return StationSpan with the ids of the group's stations
+ */
+StationSpan StationGrouping::getStations(unsigned int group) const {
+    return {members.data() + offsets[group], members.data() + offsets[group + 1]};
+}
+
+const Station &StationGrouping::getStation(unsigned int id) const {
+    return (*stations)[id];
+}
@@ -0,0 +1,61 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_STATIONGROUPING_H
+#define RAILWAYMANAGEMENT_STATIONGROUPING_H
+
+#include <string>
+#include <vector>
+#include <optional>
+#include "station.h"
+#include "dictionary.h"
+
+// Read-only view of a contiguous range of station ids
+class StationSpan {
+  private:
+    const unsigned int *first = nullptr;
+    const unsigned int *last = nullptr;
+
+  public:
+    StationSpan();
+
+    StationSpan(const unsigned int *first, const unsigned int *last);
+
+    [[nodiscard]] const unsigned int *begin() const;
+
+    [[nodiscard]] const unsigned int *end() const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] bool empty() const;
+
+    unsigned int operator[](size_t i) const;
+};
+
+class StationGrouping {
+  private:
+    const Dictionary *names = nullptr; // names of the groups
+    const std::vector<Station> *stations = nullptr;
+    std::vector<unsigned int> offsets; // the stations of group g are members[offsets[g]] to members[offsets[g + 1] - 1]
+    std::vector<unsigned int> members;
+
+  public:
+    StationGrouping();
+
+    void build(const Dictionary &groupNames, const std::vector<Station> &stationTable,
+               unsigned int (Station::*groupOf)() const);
+
+    [[nodiscard]] unsigned int size() const;
+
+    [[nodiscard]] const std::string &getName(unsigned int group) const;
+
+    [[nodiscard]] std::optional<unsigned int> find(const std::string &name) const;
+
+    [[nodiscard]] StationSpan getStations(unsigned int group) const;
+
+    [[nodiscard]] const Station &getStation(unsigned int id) const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_STATIONGROUPING_H
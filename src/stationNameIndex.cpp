@@ -0,0 +1,133 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <algorithm>
+#include <cctype>
+#include "stationNameIndex.h"
+
+StationNameIndex::StationNameIndex() = default;
+
+/**
+ * Indexes the names of a table of stations
+ * Time Complexity: O(n log(n)), n being the number of stations
+ * @param stations - Stations, indexed by id
+ */
+void StationNameIndex::build(const std::vector<Station> &stations) {
+    keys.clear();
+    for (const Station &s: stations) keys.emplace_back(normalize(s.getName()), s.getId());
+    std::sort(keys.begin(), keys.end());
+}
+
+/**
+ * Normalizes a station name for searching: letters are lowercased and the accented letters used in Portuguese (and
+ * other Latin-1 ones), written in UTF-8, lose their accent (e.g. "Campanhã" and "CAMPANHA" both become "campanha")
+ * Time Complexity: O(length(name))
+ * @param name - Name to normalize
+ * @return Normalized name
+ */
+std::string StationNameIndex::normalize(const std::string &name) {
+    // Unaccented lowercase letter for each Latin-1 character from U+00C0 to U+00FF (0 if it isn't a letter)
+    static const char latin1Letters[] = "aaaaaaaceeeeiiiidnooooo\0ouuuuyts"
+                                        "aaaaaaaceeeeiiiidnooooo\0ouuuuyty";
+    std::string normalized;
+    normalized.reserve(name.size());
+    for (size_t i = 0; i < name.size(); i++) {
+        auto c = (unsigned char) name[i];
+        if (c == 0xC3 && i + 1 < name.size()) {
+            auto next = (unsigned char) name[i + 1];
+            if (next >= 0x80 && next <= 0xBF && latin1Letters[next - 0x80] != '\0') {
+                normalized += latin1Letters[next - 0x80];
+                i++;
+                continue;
+            }
+        }
+        normalized += (char) std::tolower(c);
+    }
+    return normalized;
+}
+
+/**
+ * Finds the stations whose normalized name starts with the normalized prefix, in alphabetical order
+ * Time Complexity: O(log(n) + k), n being the number of stations and k the number of stations returned
+ * @param prefix - Beginning of the name
+ * @param limit - Maximum number of stations returned
+ * @return Ids of the stations
+ */
+std::vector<unsigned int> StationNameIndex::findPrefix(const std::string &prefix, unsigned int limit) const {
+    std::string key = normalize(prefix);
+    std::vector<unsigned int> result;
+    auto it = std::lower_bound(keys.begin(), keys.end(), std::make_pair(key, 0u));
+    for (; it != keys.end() && result.size() < limit && it->first.compare(0, key.size(), key) == 0; it++)
+        result.push_back(it->second);
+    return result;
+}
+
+/**
+ * Finds the stations whose normalized name is within an edit distance (insertions, deletions and substitutions of one
+ * character) of the normalized name given. The sorted names are walked as a trie: the rows of the edit distance table
+ * of the prefix a name shares with the previous one are reused, and once every entry of a row exceeds maxDistance, all
+ * the names sharing that prefix are skipped at once
+ * Time Complexity: O(p m), p being the number of prefixes visited and m the length of name (at worst, p is the total
+ * length of the names)
+ * @param name - Name to look for
+ * @param maxDistance - Maximum edit distance
+ * @param limit - Maximum number of stations returned
+ * @return Ids of the closest stations and their distance, by increasing distance and then alphabetically
+ */
+std::vector<std::pair<unsigned int, unsigned int>>
+StationNameIndex::findSimilar(const std::string &name, unsigned int maxDistance, unsigned int limit) const {
+    std::string query = normalize(name);
+    const size_t m = query.size();
+    std::vector<std::vector<unsigned int>> rows(1, std::vector<unsigned int>(m + 1));
+    for (size_t j = 0; j <= m; j++) rows[0][j] = (unsigned int) j;
+
+    std::vector<std::pair<unsigned int, size_t>> matches; // distance and position in keys
+    const std::string *previous = nullptr;
+    size_t validRows = 0; // rows[1..validRows] belong to the prefixes of *previous
+
+    size_t i = 0;
+    while (i < keys.size()) {
+        const std::string &key = keys[i].first;
+        size_t depth = 0;
+        if (previous != nullptr)
+            while (depth < validRows && depth < key.size() && (*previous)[depth] == key[depth]) depth++;
+
+        bool pruned = false;
+        for (; depth < key.size(); depth++) {
+            if (rows.size() <= depth + 1) rows.emplace_back(m + 1);
+            const std::vector<unsigned int> &above = rows[depth];
+            std::vector<unsigned int> &row = rows[depth + 1];
+            row[0] = (unsigned int) depth + 1;
+            unsigned int rowMin = row[0];
+            for (size_t j = 1; j <= m; j++) {
+                row[j] = std::min({above[j] + 1, row[j - 1] + 1, above[j - 1] + (key[depth] != query[j - 1])});
+                rowMin = std::min(rowMin, row[j]);
+            }
+            if (rowMin > maxDistance) {
+                // No name starting with this prefix can get close enough
+                std::string prefix = key.substr(0, depth + 1);
+                i = std::upper_bound(keys.begin() + (long) i, keys.end(), prefix,
+                                     [](const std::string &p, const std::pair<std::string, unsigned int> &k) {
+                                         return k.first.compare(0, p.size(), p) > 0;
+                                     }) - keys.begin();
+                previous = &key;
+                validRows = depth + 1;
+                pruned = true;
+                break;
+            }
+        }
+        if (pruned) continue;
+
+        if (rows[key.size()][m] <= maxDistance) matches.emplace_back(rows[key.size()][m], i);
+        previous = &key;
+        validRows = key.size();
+        i++;
+    }
+
+    std::sort(matches.begin(), matches.end());
+    std::vector<std::pair<unsigned int, unsigned int>> result;
+    for (size_t k = 0; k < matches.size() && k < limit; k++)
+        result.emplace_back(keys[matches[k].second].second, matches[k].first);
+    return result;
+}
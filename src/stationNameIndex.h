@@ -0,0 +1,31 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_STATIONNAMEINDEX_H
+#define RAILWAYMANAGEMENT_STATIONNAMEINDEX_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "station.h"
+
+class StationNameIndex {
+  private:
+    std::vector<std::pair<std::string, unsigned int>> keys; // normalized name and station id, sorted by name
+
+  public:
+    StationNameIndex();
+
+    void build(const std::vector<Station> &stations);
+
+    static std::string normalize(const std::string &name);
+
+    [[nodiscard]] std::vector<unsigned int> findPrefix(const std::string &prefix, unsigned int limit) const;
+
+    [[nodiscard]] std::vector<std::pair<unsigned int, unsigned int>>
+    findSimilar(const std::string &name, unsigned int maxDistance, unsigned int limit) const;
+};
+
+
+#endif //RAILWAYMANAGEMENT_STATIONNAMEINDEX_H
@@ -0,0 +1,84 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include "terminalArcs.h"
+#include <algorithm>
+
+/**
+ * Creates the virtual arcs of a network with no sources nor sinks
+ * Time Complexity: O(|V|)
+ * @param numVertices - Number of vertices of the network
+ */
+TerminalArcs::TerminalArcs(unsigned int numVertices)
+        : supply(numVertices, 0), demand(numVertices, 0), supplied(numVertices, 0), delivered(numVertices, 0) {}
+
+/**
+ * Makes a vertex a source, or adds to its supply if it already is one
+ * Time Complexity: O(1)
+ * @param vertex - Index of the Vertex
+ * @param capacity - Supply of the station, INFINITE_CAPACITY if unbounded
+ */
+void TerminalArcs::addSource(unsigned int vertex, Capacity capacity) {
+    supply[vertex] = capacity > INFINITE_CAPACITY - supply[vertex] ? INFINITE_CAPACITY : supply[vertex] + capacity;
+}
+
+/**
+ * Makes a vertex a sink, or adds to its demand if it already is one
+ * Time Complexity: O(1)
+ * @param vertex - Index of the Vertex
+ * @param capacity - Demand of the station, INFINITE_CAPACITY if unbounded
+ */
+void TerminalArcs::addSink(unsigned int vertex, Capacity capacity) {
+    demand[vertex] = capacity > INFINITE_CAPACITY - demand[vertex] ? INFINITE_CAPACITY : demand[vertex] + capacity;
+}
+
+Capacity TerminalArcs::getSupply(unsigned int vertex) const {
+    return supply[vertex];
+}
+
+Capacity TerminalArcs::getDemand(unsigned int vertex) const {
+    return demand[vertex];
+}
+
+Capacity TerminalArcs::getSupplied(unsigned int vertex) const {
+    return supplied[vertex];
+}
+
+Capacity TerminalArcs::getDelivered(unsigned int vertex) const {
+    return delivered[vertex];
+}
+
+/**
+ * Sends flow through the arc into a source and the arc out of a sink, as the ends of an augmenting path
+ * Time Complexity: O(1)
+ * @param source - Index of the Vertex the path starts at
+ * @param sink - Index of the Vertex the path ends at
+ * @param amount - Flow the path's edges can carry
+ * @return Flow sent: amount, limited by the supply left at the source and the demand left at the sink
+ */
+Capacity TerminalArcs::use(unsigned int source, unsigned int sink, Capacity amount) {
+    amount = std::min({amount, supply[source], demand[sink]});
+    if (supply[source] != INFINITE_CAPACITY) supply[source] -= amount;
+    if (demand[sink] != INFINITE_CAPACITY) demand[sink] -= amount;
+    supplied[source] += amount;
+    delivered[sink] += amount;
+    return amount;
+}
+
+/**
+ * Sends flow straight from the super source to the super sink through the stations that are both a source and a sink,
+ * which needs no rail, so that afterwards no station is left with both supply and demand. A station with unbounded
+ * supply and demand would carry unbounded flow, so, like the target of a single-target query, it is only kept as a sink
+ * Time Complexity: O(|V|)
+ * @return Flow sent
+ */
+Capacity TerminalArcs::connectTerminals() {
+    Capacity flow = 0;
+    for (unsigned int v = 0; v < supply.size(); v++) {
+        if (supply[v] == 0 || demand[v] == 0) continue;
+        if (supply[v] == INFINITE_CAPACITY && demand[v] == INFINITE_CAPACITY) supply[v] = 0;
+        else flow += use(v, v, INFINITE_CAPACITY);
+    }
+    return flow;
+}
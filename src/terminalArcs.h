@@ -0,0 +1,45 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_TERMINALARCS_H
+#define RAILWAYMANAGEMENT_TERMINALARCS_H
+
+#include <vector>
+#include "flowTypes.h"
+
+/**
+ * Virtual arcs from a super source to every source station and from every sink station to a super sink, kept as
+ * per-vertex arrays instead of extra Vertex and Edge objects. Each arc has a capacity (the station's supply or demand,
+ * INFINITE_CAPACITY if unbounded) and the flow it carries; augmenting paths never use their reverses, as a path from
+ * the super source can't go back into it nor leave the super sink
+ */
+class TerminalArcs {
+  private:
+    std::vector<Capacity> supply; // capacity left on the arc into each vertex, 0 if it isn't a source
+    std::vector<Capacity> demand; // capacity left on the arc out of each vertex, 0 if it isn't a sink
+    std::vector<Capacity> supplied; // flow on the arc into each vertex
+    std::vector<Capacity> delivered; // flow on the arc out of each vertex
+
+  public:
+    explicit TerminalArcs(unsigned int numVertices);
+
+    void addSource(unsigned int vertex, Capacity capacity = INFINITE_CAPACITY);
+
+    void addSink(unsigned int vertex, Capacity capacity = INFINITE_CAPACITY);
+
+    [[nodiscard]] Capacity getSupply(unsigned int vertex) const;
+
+    [[nodiscard]] Capacity getDemand(unsigned int vertex) const;
+
+    [[nodiscard]] Capacity getSupplied(unsigned int vertex) const;
+
+    [[nodiscard]] Capacity getDelivered(unsigned int vertex) const;
+
+    Capacity use(unsigned int source, unsigned int sink, Capacity amount);
+
+    Capacity connectTerminals();
+};
+
+
+#endif //RAILWAYMANAGEMENT_TERMINALARCS_H
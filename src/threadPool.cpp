@@ -0,0 +1,84 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#include <utility>
+#include "threadPool.h"
+
+/**
+ * Starts a pool with a fixed number of worker threads
+ * @param numWorkers - Number of worker threads (at least one is always started)
+ */
+ThreadPool::ThreadPool(unsigned int numWorkers) {
+    if (numWorkers == 0) numWorkers = 1;
+    for (unsigned int i = 0; i < numWorkers; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+/**
+ * Finishes the tasks already submitted and joins every worker thread
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (std::thread &worker: workers) worker.join();
+}
+
+unsigned int ThreadPool::getNumWorkers() const {
+    return (unsigned int) workers.size();
+}
+
+/**
+ * Queues a task to be run by the first free worker. The task receives the id of the worker running it (0 to
+ * getNumWorkers() - 1), so that it can use per-worker state without further synchronization
+ * Time Complexity: O(1)
+ * @param task - Function to run
+ */
+void ThreadPool::submit(std::function<void(unsigned int)> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+        pending++;
+    }
+    taskAvailable.notify_one();
+}
+
+/**
+ * Blocks until every submitted task has finished running. If any of them threw, the first exception is rethrown here,
+ * as an exception escaping a worker thread would terminate the program
+ */
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+    if (failure != nullptr) std::rethrow_exception(std::exchange(failure, nullptr));
+}
+
+void ThreadPool::workerLoop(unsigned int workerId) {
+    while (true) {
+        std::function<void(unsigned int)> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        std::exception_ptr thrown;
+        try {
+            task(workerId);
+        } catch (...) {
+            thrown = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (thrown != nullptr && failure == nullptr) failure = thrown;
+            pending--;
+            if (pending == 0) allDone.notify_all();
+        }
+    }
+}
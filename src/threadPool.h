@@ -0,0 +1,46 @@
+//
+// Created by agent on 18-10-2026.
+//
+
+#ifndef RAILWAYMANAGEMENT_THREADPOOL_H
+#define RAILWAYMANAGEMENT_THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+class ThreadPool {
+  private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void(unsigned int)>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    unsigned int pending = 0;
+    bool stopping = false;
+    std::exception_ptr failure; // first exception thrown by a task since the last wait()
+
+    void workerLoop(unsigned int workerId);
+
+  public:
+    explicit ThreadPool(unsigned int numWorkers);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    [[nodiscard]] unsigned int getNumWorkers() const;
+
+    void submit(std::function<void(unsigned int)> task);
+
+    void wait();
+};
+
+
+#endif //RAILWAYMANAGEMENT_THREADPOOL_H
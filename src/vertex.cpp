@@ -16,7 +16,7 @@ Vertex::Vertex(std::string id) : id(std::move(id)) {}
  * @param service - Service of the Edge
  * @return Pointer to the new Edge created
  */
-Edge *Vertex::addEdge(Vertex *d, unsigned int w, Service service) {
+Edge *Vertex::addEdge(Vertex *d, Capacity w, Service service) {
     auto newEdge = new Edge(this, d, w, service);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
@@ -59,7 +59,7 @@ std::string Vertex::getId() const {
     return this->id;
 }
 
-std::vector<Edge *> Vertex::getAdj() const {
+const std::vector<Edge *> &Vertex::getAdj() const {
     return this->adj;
 }
 
@@ -75,7 +75,7 @@ unsigned int Vertex::getIndegree() const {
     return this->indegree;
 }
 
-int Vertex::getCost() const {
+Cost Vertex::getCost() const {
     return this->cost;
 }
 
@@ -83,7 +83,7 @@ Edge *Vertex::getPath() const {
     return this->path;
 }
 
-std::vector<Edge *> Vertex::getIncoming() const {
+const std::vector<Edge *> &Vertex::getIncoming() const {
     return this->incoming;
 }
 
@@ -103,10 +103,18 @@ void Vertex::setIndegree(unsigned int indegree) {
     this->indegree = indegree;
 }
 
-void Vertex::setCost(int cost) {
+void Vertex::setCost(Cost cost) {
     this->cost = cost;
 }
 
 void Vertex::setPath(Edge *path) {
     this->path = path;
-}
\ No newline at end of file
+}
+
+unsigned int Vertex::getIndex() const {
+    return this->index;
+}
+
+void Vertex::setIndex(unsigned int index) {
+    this->index = index;
+}
@@ -11,6 +11,7 @@
 #include <limits>
 #include <algorithm>
 #include "edge.h"
+#include "flowTypes.h"
 
 #define INF std::numeric_limits<double>::max()
 
@@ -23,7 +24,7 @@ public:
 
     [[nodiscard]] std::string getId() const;
 
-    [[nodiscard]] std::vector<Edge *> getAdj() const;
+    [[nodiscard]] const std::vector<Edge *> &getAdj() const;
 
     [[nodiscard]] bool isVisited() const;
 
@@ -31,11 +32,13 @@ public:
 
     [[nodiscard]] unsigned int getIndegree() const;
 
-    [[nodiscard]] int getCost() const;
+    [[nodiscard]] Cost getCost() const;
 
     [[nodiscard]] Edge *getPath() const;
 
-    [[nodiscard]] std::vector<Edge *> getIncoming() const;
+    [[nodiscard]] const std::vector<Edge *> &getIncoming() const;
+
+    [[nodiscard]] unsigned int getIndex() const;
 
     void setId(std::string info);
 
@@ -45,23 +48,26 @@ public:
 
     void setIndegree(unsigned int indegree);
 
-    void setCost(int dist);
+    void setCost(Cost dist);
 
     void setPath(Edge *path);
 
-    Edge *addEdge(Vertex *dest, unsigned int w, Service s);
+    void setIndex(unsigned int index);
+
+    Edge *addEdge(Vertex *dest, Capacity w, Service s);
 
     bool removeEdge(const std::string& destID);
 
 private:
     std::string id;                // identifier
+    unsigned int index = 0;        // position in the Graph's vertex set
     std::vector<Edge *> adj;  // outgoing edges
 
     // auxiliary fields
     bool visited = false; // used by DFS, BFS, Prim ...
     bool processing = false; // used by isDAG (in addition to the visited attribute)
     unsigned int indegree; // used by topsort
-    int cost;
+    Cost cost;
     Edge *path = nullptr;
     std::vector<Edge *> incoming; // incoming edges
 